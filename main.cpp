@@ -1,7 +1,7 @@
 #include "Game.h"
 
-int main() {
-    Game game; // Create a Game object
+int main(int argc, char* argv[]) {
+    Game game(parseGameOptions(argc, argv)); // Create a Game object from the command line flags
     game.run(); // Start the game loop
-    return 0;
+    return game.exitCode(); // Non-zero when a latency budget was exceeded
 }
@@ -0,0 +1,56 @@
+#include "Assets.hpp"
+#include "EmbeddedFont.hpp" // Generated from src/font/font.ttf at build time
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping stays valid after closing the descriptor
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    m_data = static_cast<const char*>(data);
+    m_size = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data) {
+        munmap(const_cast<char*>(m_data), m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
+
+std::string loadFont(sf::Font& font, MappedFile& mapping, const std::string& overridePath) {
+    if (!overridePath.empty()) {
+        if (mapping.open(overridePath) && font.loadFromMemory(mapping.data(), mapping.size())) {
+            return "mapped " + overridePath;
+        }
+        std::cerr << "Failed to load font override: " << overridePath << ", using embedded font\n";
+        mapping.close();
+    }
+
+    if (!font.loadFromMemory(embeddedFontData, embeddedFontSize)) {
+        std::cerr << "Failed to load embedded font!" << std::endl;
+        return "none";
+    }
+    return "embedded";
+}
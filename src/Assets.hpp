@@ -0,0 +1,32 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file, unmapped on destruction
+class MappedFile {
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the file; returns false if it is missing or empty
+    bool open(const std::string& path);
+    void close();
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool isOpen() const { return m_data != nullptr; }
+};
+
+// Loads the HUD font, preferring overridePath (memory mapped) when given and
+// falling back to the copy compiled into the binary. The mapping must outlive
+// the font, since SFML reads glyphs from that memory lazily.
+// Returns a short description of where the font came from.
+std::string loadFont(sf::Font& font, MappedFile& mapping, const std::string& overridePath);
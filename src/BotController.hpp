@@ -0,0 +1,104 @@
+#pragma once
+
+#include "EntityManager.hpp"
+#include "Components.hpp"
+#include "RandomStream.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Drives a player's CInput for unattended load tests
+// Each update the bot dodges when enemies crowd it and random-walks
+// otherwise, always aiming at the nearest enemy (leading its motion) and
+// firing whenever the weapon is ready. It draws from its own random stream so bot
+// runs are repeatable for a given seed.
+class BotController {
+public:
+    // === Tuning ===
+    float dodgeRadius = 220.0f;      // Enemies closer than this push the bot away
+    float dodgeThreshold = 0.35f;    // Summed push strength that switches from walking to dodging
+    float wallMargin = 120.0f;       // Random walk steers back toward the center inside this margin
+    float minWalkTime = 0.5f;        // Seconds between random walk direction changes
+    float maxWalkTime = 2.0f;
+    float supermoveRadius = 250.0f;  // Supermove when this many enemies are this close...
+    size_t supermoveCrowd = 4;       // ...and it is ready
+
+    // Bots that share a seed (one per game of a sweep) tell themselves apart by substream
+    explicit BotController(uint32_t seed = 1, uint32_t substream = 0) : m_random(seed, RandomStreamId::Bot, substream) {}
+
+    // Writes the player's input for this update. leadTime is how long a
+    // bullet takes to reach its aim point, used to lead moving enemies; now is
+    // the game time the weapon cooldowns are measured against.
+    void control(Entity& player, const EntityVec& enemies, float width, float height, float leadTime, double now, float dt) {
+        auto& input = player.get<CInput>();
+        const auto& transform = player.get<CTransform>();
+        const Vec2<float>& position = transform.position;
+
+        // Nearest enemy, and the push away from every enemy in dodge range
+        const Entity* nearest = nullptr;
+        float nearestDistanceSq = 0.0f;
+        Vec2<float> push(0.0f, 0.0f);
+        size_t crowd = 0;
+        for (const auto& enemy : enemies) {
+            Vec2<float> offset = position - enemy->get<CTransform>().position;
+            float distanceSq = offset.x * offset.x + offset.y * offset.y;
+            if (!nearest || distanceSq < nearestDistanceSq) {
+                nearest = enemy.get();
+                nearestDistanceSq = distanceSq;
+            }
+            if (distanceSq < dodgeRadius * dodgeRadius && distanceSq > 0.0f) {
+                float distance = std::sqrt(distanceSq);
+                float weight = 1.0f - distance / dodgeRadius; // Stronger when closer
+                push += offset * (weight / distance);
+            }
+            if (distanceSq < supermoveRadius * supermoveRadius) {
+                ++crowd;
+            }
+        }
+
+        // Movement: dodge when threatened, otherwise random walk
+        Vec2<float> direction;
+        if (push.magnitude() > dodgeThreshold) {
+            direction = push;
+        } else {
+            m_walkTimer -= dt;
+            if (m_walkTimer <= 0.0f) {
+                float radians = m_random.uniform() * 6.2831853f;
+                m_walkDirection = Vec2<float>(std::cos(radians), std::sin(radians));
+                m_walkTimer = minWalkTime + m_random.uniform() * (maxWalkTime - minWalkTime);
+            }
+            direction = m_walkDirection;
+        }
+
+        // Keep away from the walls (the player is clamped there and easy to corner)
+        if (position.x < wallMargin) direction.x = std::abs(direction.x) + 0.5f;
+        if (position.x > width - wallMargin) direction.x = -std::abs(direction.x) - 0.5f;
+        if (position.y < wallMargin) direction.y = std::abs(direction.y) + 0.5f;
+        if (position.y > height - wallMargin) direction.y = -std::abs(direction.y) - 0.5f;
+
+        // Press keys like a player would (8 directions)
+        input.up = direction.y < -0.3f;
+        input.down = direction.y > 0.3f;
+        input.left = direction.x < -0.3f;
+        input.right = direction.x > 0.3f;
+        input.move = Vec2<float>(static_cast<float>(input.right - input.left), static_cast<float>(input.down - input.up));
+
+        // Aim at the nearest enemy, leading its motion
+        input.fire = false;
+        input.supermove = false;
+        input.fireTime = 0.0f;
+        input.supermoveTime = 0.0f;
+        if (nearest) {
+            const auto& target = nearest->get<CTransform>();
+            input.aim = target.position + target.velocity * leadTime;
+
+            const auto& weapon = player.get<CWeapon>();
+            input.fire = weapon.shotReadyTime <= now;
+            input.supermove = weapon.supermoveReadyTime <= now && crowd >= supermoveCrowd;
+        }
+    }
+
+private:
+    RandomStream m_random; // Same walk on every standard library, unlike std distributions
+    Vec2<float> m_walkDirection{0.0f, 0.0f};
+    float m_walkTimer = 0.0f;
+};
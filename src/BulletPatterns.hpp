@@ -0,0 +1,203 @@
+#pragma once
+
+#include "Vec2.hpp"
+#include "RenderCulling.hpp"
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// One emitter's worth of bullets, described by its parameters alone
+// Bullet i leaves origin at spawnTime + i * interval heading baseAngle +
+// i * angleStep, and at age a sits at
+//   origin + dir * speed * a + perp * waveAmplitude * sin(waveFrequency * a)
+// so a pattern of any size is a few dozen bytes plus one bit per bullet.
+struct BulletPattern {
+    Vec2<float> origin;
+    double spawnTime = 0.0;       // When bullet 0 leaves the origin (pattern clock)
+    float interval = 0.0f;        // Delay between consecutive bullets (0 = all at once)
+    float baseAngle = 0.0f;       // Heading of bullet 0 (radians)
+    float angleStep = 0.0f;       // Heading added per bullet (radians)
+    float speed = 0.0f;
+    float waveAmplitude = 0.0f;   // Sideways sine offset (0 = straight line)
+    float waveFrequency = 0.0f;   // Radians per second of age
+    float lifetime = 1.0f;        // Seconds each bullet lives
+    float radius = 5.0f;
+    uint32_t count = 0;
+    sf::Color color = sf::Color::White;
+
+    // === Emitters ===
+    // count bullets leaving together, evenly spread around a full circle
+    static BulletPattern ring(const Vec2<float>& origin, double spawnTime, uint32_t count, float speed, float startAngle = 0.0f) {
+        BulletPattern pattern = make(origin, spawnTime, count, speed);
+        pattern.baseAngle = startAngle;
+        pattern.angleStep = 2.0f * static_cast<float>(M_PI) / std::max(count, 1u);
+        return pattern;
+    }
+
+    // One bullet every interval seconds, each turned by angleStep from the last
+    static BulletPattern spiral(const Vec2<float>& origin, double spawnTime, uint32_t count, float speed,
+                                float interval, float angleStep, float startAngle = 0.0f) {
+        BulletPattern pattern = make(origin, spawnTime, count, speed);
+        pattern.interval = interval;
+        pattern.baseAngle = startAngle;
+        pattern.angleStep = angleStep;
+        return pattern;
+    }
+
+    // count bullets fanned over spread radians centred on aim (interval > 0 staggers them)
+    static BulletPattern aimedBurst(const Vec2<float>& origin, double spawnTime, uint32_t count, float speed,
+                                    const Vec2<float>& aim, float spread, float interval = 0.0f) {
+        BulletPattern pattern = make(origin, spawnTime, count, speed);
+        Vec2<float> direction = aim - origin;
+        float heading = std::atan2(direction.y, direction.x);
+        pattern.interval = interval;
+        pattern.angleStep = count > 1 ? spread / (count - 1) : 0.0f;
+        pattern.baseAngle = heading - spread / 2.0f;
+        return pattern;
+    }
+
+    // A stream along heading whose bullets weave amplitude pixels either side
+    static BulletPattern sineWave(const Vec2<float>& origin, double spawnTime, uint32_t count, float speed,
+                                  float heading, float interval, float amplitude, float frequency) {
+        BulletPattern pattern = make(origin, spawnTime, count, speed);
+        pattern.interval = interval;
+        pattern.baseAngle = heading;
+        pattern.waveAmplitude = amplitude;
+        pattern.waveFrequency = frequency;
+        return pattern;
+    }
+
+    // Pattern clock time at which the last bullet expires
+    double endTime() const { return spawnTime + static_cast<double>(interval) * (count - 1) + lifetime; }
+
+private:
+    static BulletPattern make(const Vec2<float>& origin, double spawnTime, uint32_t count, float speed) {
+        BulletPattern pattern;
+        pattern.origin = origin;
+        pattern.spawnTime = spawnTime;
+        pattern.count = count;
+        pattern.speed = speed;
+        return pattern;
+    }
+};
+
+// Bullet-hell scale bullets with no per-frame state
+// Patterns are stored instead of bullets: a position is computed in closed
+// form from the pattern clock only when collision or rendering asks for it,
+// so advancing time is O(patterns) however many bullets are in flight. The
+// only per-bullet state is a killed bit. Headings are stepped by rotating
+// the previous bullet's direction, so evaluating a pattern needs no trig
+// unless it weaves.
+class BulletPatternSystem {
+    struct Emitter {
+        BulletPattern pattern;
+        std::vector<uint64_t> killed; // One bit per bullet
+        uint32_t alive;               // Bullets not yet killed
+    };
+
+    std::vector<Emitter> m_emitters;
+    double m_time = 0.0; // Pattern clock (seconds)
+
+    static bool isKilled(const Emitter& emitter, uint32_t i) { return (emitter.killed[i >> 6] >> (i & 63)) & 1u; }
+
+    // Position of a bullet with heading (c, s) at the given age
+    static Vec2<float> positionAt(const BulletPattern& p, double c, double s, double age) {
+        double forward = p.speed * age;
+        double side = p.waveAmplitude != 0.0f ? p.waveAmplitude * std::sin(p.waveFrequency * age) : 0.0;
+        return Vec2<float>(static_cast<float>(p.origin.x + c * forward - s * side),
+                           static_cast<float>(p.origin.y + s * forward + c * side));
+    }
+
+public:
+    // Reference to one bullet, for kill()
+    struct BulletRef {
+        uint32_t emitter;
+        uint32_t bullet;
+    };
+
+    // Starts a pattern (spawnTime may be a little ahead of time() for backdated input)
+    void emit(const BulletPattern& pattern) {
+        if (pattern.count == 0) {
+            return;
+        }
+        m_emitters.push_back(Emitter{pattern, std::vector<uint64_t>((pattern.count + 63) / 64, 0), pattern.count});
+    }
+
+    // Advances the clock and drops patterns whose bullets have all expired or been killed
+    void update(double dt) {
+        m_time += dt;
+        for (size_t i = 0; i < m_emitters.size();) {
+            if (m_emitters[i].alive == 0 || m_emitters[i].pattern.endTime() <= m_time) {
+                m_emitters[i] = std::move(m_emitters.back());
+                m_emitters.pop_back();
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    // Calls fn(ref, from, to, radius) for every live bullet, with from its position
+    // dt seconds ago (or where it was fired, if that was during the step)
+    template <typename Fn>
+    void forEachBullet(double dt, Fn&& fn) const {
+        for (size_t e = 0; e < m_emitters.size(); ++e) {
+            const Emitter& emitter = m_emitters[e];
+            const BulletPattern& p = emitter.pattern;
+            double stepC = std::cos(static_cast<double>(p.angleStep)), stepS = std::sin(static_cast<double>(p.angleStep));
+            double c = std::cos(static_cast<double>(p.baseAngle)), s = std::sin(static_cast<double>(p.baseAngle));
+            for (uint32_t i = 0; i < p.count; ++i) {
+                double age = m_time - (p.spawnTime + static_cast<double>(p.interval) * i);
+                if (age < 0.0) {
+                    break; // Later bullets are not fired yet
+                }
+                if (age < p.lifetime && !isKilled(emitter, i)) {
+                    fn(BulletRef{static_cast<uint32_t>(e), i}, positionAt(p, c, s, std::max(0.0, age - dt)),
+                       positionAt(p, c, s, age), p.radius);
+                }
+                double nextC = c * stepC - s * stepS;
+                s = c * stepS + s * stepC;
+                c = nextC;
+            }
+        }
+    }
+
+    void kill(BulletRef ref) {
+        Emitter& emitter = m_emitters[ref.emitter];
+        uint64_t& word = emitter.killed[ref.bullet >> 6];
+        uint64_t bit = uint64_t{1} << (ref.bullet & 63);
+        if (!(word & bit)) {
+            word |= bit;
+            --emitter.alive;
+        }
+    }
+
+    // Appends every visible bullet as a filled polygon (sf::Triangles), for one draw call
+    // Bullets get at most maxSides sides, fewer when they are small on screen.
+    void appendVertices(std::vector<sf::Vertex>& out, const RenderView& view, int maxSides = 8) const {
+        forEachBullet(0.0, [&](BulletRef ref, const Vec2<float>&, const Vec2<float>& position, float radius) {
+            if (!view.visible(position.x, position.y, radius)) {
+                return;
+            }
+            const sf::Color& color = m_emitters[ref.emitter].pattern.color;
+            if (radius < pointSpriteRadius) {
+                appendQuad(out, position.x, position.y, radius, color);
+            } else {
+                appendDisc(out, position.x, position.y, radius, circleSides(radius, maxSides), color);
+            }
+        });
+    }
+
+    // Bullets fired and neither expired nor killed
+    size_t liveBullets() const {
+        size_t count = 0;
+        forEachBullet(0.0, [&](BulletRef, const Vec2<float>&, const Vec2<float>&, float) { ++count; });
+        return count;
+    }
+
+    size_t patterns() const { return m_emitters.size(); }
+    double time() const { return m_time; }
+
+    void clear() { m_emitters.clear(); }
+};
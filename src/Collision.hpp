@@ -0,0 +1,218 @@
+#pragma once
+
+#include "Vec2.hpp"
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+// Collision layers: every collider (CCollision) sits on exactly one layer
+enum class CollisionLayer : uint8_t {
+    None,   // Not a collider
+    Player,
+    Enemy,
+    Bullet,
+};
+constexpr size_t collisionLayerCount = 4;
+
+using CollisionLayerMask = uint32_t;
+
+constexpr CollisionLayerMask layerBit(CollisionLayer layer) {
+    return 1u << static_cast<unsigned>(layer);
+}
+
+// Which layer pairs interact (symmetric), and the order they are resolved in
+// A pair is enabled as (query, target): each query collider is tested against
+// the target layer and sees its contacts in time-of-impact order.
+class CollisionMatrix {
+    std::array<CollisionLayerMask, collisionLayerCount> m_masks{};
+    std::vector<std::pair<CollisionLayer, CollisionLayer>> m_pairs;
+
+public:
+    void enable(CollisionLayer query, CollisionLayer target) {
+        if (interacts(query, target) || query == CollisionLayer::None || target == CollisionLayer::None) {
+            return;
+        }
+        m_masks[static_cast<size_t>(query)] |= layerBit(target);
+        m_masks[static_cast<size_t>(target)] |= layerBit(query);
+        m_pairs.emplace_back(query, target);
+    }
+
+    bool interacts(CollisionLayer a, CollisionLayer b) const {
+        return (m_masks[static_cast<size_t>(a)] & layerBit(b)) != 0;
+    }
+
+    // Layers that a layer interacts with (0 = its colliders are never tested)
+    CollisionLayerMask mask(CollisionLayer layer) const { return m_masks[static_cast<size_t>(layer)]; }
+
+    const std::vector<std::pair<CollisionLayer, CollisionLayer>>& pairs() const { return m_pairs; }
+};
+
+// Swept circle-vs-circle test
+// Circle A moves from a0 to a1 and circle B from b0 to b1 over one step.
+// Returns true if they touch during the step and writes the earliest
+// normalized time of impact (0 = start of step, 1 = end of step) to toi.
+inline bool sweptCircleCircle(const Vec2<float>& a0, const Vec2<float>& a1,
+                              const Vec2<float>& b0, const Vec2<float>& b1,
+                              float radiusSum, float& toi) {
+    // Work in B's frame: A moves along s + t * d
+    Vec2<float> s = a0 - b0;
+    Vec2<float> d = (a1 - a0) - (b1 - b0);
+
+    float c = s.dot(s) - radiusSum * radiusSum;
+    if (c <= 0.0f) {
+        toi = 0.0f; // Already overlapping at the start of the step
+        return true;
+    }
+
+    float a = d.dot(d);
+    if (a <= 1e-12f) {
+        return false; // No relative motion and not overlapping
+    }
+
+    float b = s.dot(d);
+    if (b >= 0.0f) {
+        return false; // Moving apart
+    }
+
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f) {
+        return false; // Closest approach is still outside the radius sum
+    }
+
+    float t = (-b - std::sqrt(discriminant)) / a;
+    if (t > 1.0f) {
+        return false; // Contact happens after this step
+    }
+
+    toi = std::max(0.0f, t);
+    return true;
+}
+
+// Uniform grid used as broad phase for swept tests
+// Items are inserted by bounding box; moving queries walk the cells within
+// their radius of the segment they sweep (Amanatides-Woo traversal).
+class SpatialGrid {
+    float m_cellSize = 64.0f;
+    int m_cols = 1;
+    int m_rows = 1;
+    std::vector<std::vector<size_t>> m_cells; // Item indices per cell
+
+    int cellX(float x) const { return std::clamp(static_cast<int>(std::floor(x / m_cellSize)), 0, m_cols - 1); }
+    int cellY(float y) const { return std::clamp(static_cast<int>(std::floor(y / m_cellSize)), 0, m_rows - 1); }
+
+public:
+    // Resize the grid to cover a world of the given size and remove all items
+    void reset(float worldWidth, float worldHeight, float cellSize) {
+        m_cellSize = cellSize;
+        m_cols = std::max(1, static_cast<int>(std::ceil(worldWidth / cellSize)));
+        m_rows = std::max(1, static_cast<int>(std::ceil(worldHeight / cellSize)));
+        m_cells.resize(static_cast<size_t>(m_cols) * m_rows);
+        clear();
+    }
+
+    // Remove all items but keep cell capacity for the next frame
+    void clear() {
+        for (auto& cell : m_cells) {
+            cell.clear();
+        }
+    }
+
+    // Insert an item into every cell overlapped by the box [min, max]
+    // Positions outside the world are clamped to the border cells.
+    void insert(size_t item, const Vec2<float>& min, const Vec2<float>& max) {
+        int x0 = cellX(min.x), x1 = cellX(max.x);
+        int y0 = cellY(min.y), y1 = cellY(max.y);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                m_cells[static_cast<size_t>(y) * m_cols + x].push_back(item);
+            }
+        }
+    }
+
+    // Call visit(item) for every item in the cells overlapped by the box [min, max]
+    // Items spanning several cells can be visited more than once.
+    template <typename Visitor>
+    void queryBox(const Vec2<float>& min, const Vec2<float>& max, Visitor&& visit) const {
+        int x0 = cellX(min.x), x1 = cellX(max.x);
+        int y0 = cellY(min.y), y1 = cellY(max.y);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                for (size_t item : m_cells[static_cast<size_t>(y) * m_cols + x]) {
+                    visit(item);
+                }
+            }
+        }
+    }
+
+    // Call visit(item) for every item in the cells within radius of the segment p0 -> p1
+    // The cells along the segment are walked (Amanatides-Woo) and each step
+    // only visits the edge of cells it newly brings within reach, so a long
+    // diagonal sweep costs O(length) cells where its bounding box costs
+    // O(length^2). Short sweeps, and segments that leave the grid (items
+    // outside it sit in the clamped border cells), use the box instead,
+    // whichever visits fewer cells. Items spanning several cells can be
+    // visited more than once.
+    template <typename Visitor>
+    void querySegment(const Vec2<float>& p0, const Vec2<float>& p1, float radius, Visitor&& visit) const {
+        Vec2<float> min(std::min(p0.x, p1.x) - radius, std::min(p0.y, p1.y) - radius);
+        Vec2<float> max(std::max(p0.x, p1.x) + radius, std::max(p0.y, p1.y) + radius);
+        int x = cellX(p0.x), y = cellY(p0.y);
+        int endX = cellX(p1.x), endY = cellY(p1.y);
+        int reach = static_cast<int>(std::ceil(radius / m_cellSize)); // Cells around the walked one
+        int width = 2 * reach + 1;
+        int remaining = std::abs(endX - x) + std::abs(endY - y);
+        long boxCells = static_cast<long>(cellX(max.x) - cellX(min.x) + 1) * (cellY(max.y) - cellY(min.y) + 1);
+        bool inside = std::min(p0.x, p1.x) >= 0.0f && std::min(p0.y, p1.y) >= 0.0f &&
+                      std::max(p0.x, p1.x) < m_cols * m_cellSize && std::max(p0.y, p1.y) < m_rows * m_cellSize;
+        if (!inside || boxCells <= static_cast<long>(width) * (width + remaining)) {
+            queryBox(min, max, visit);
+            return;
+        }
+
+        auto visitCells = [&](int fromX, int toX, int fromY, int toY) {
+            for (int cy = std::max(fromY, 0); cy <= std::min(toY, m_rows - 1); ++cy) {
+                for (int cx = std::max(fromX, 0); cx <= std::min(toX, m_cols - 1); ++cx) {
+                    for (size_t item : m_cells[static_cast<size_t>(cy) * m_cols + cx]) {
+                        visit(item);
+                    }
+                }
+            }
+        };
+
+        Vec2<float> d = p1 - p0;
+        int stepX = d.x > 0.0f ? 1 : (d.x < 0.0f ? -1 : 0);
+        int stepY = d.y > 0.0f ? 1 : (d.y < 0.0f ? -1 : 0);
+
+        // Parametric distance to the next cell border on each axis, and per cell
+        const float inf = std::numeric_limits<float>::infinity();
+        float tDeltaX = stepX != 0 ? m_cellSize / std::abs(d.x) : inf;
+        float tDeltaY = stepY != 0 ? m_cellSize / std::abs(d.y) : inf;
+        float tMaxX = stepX > 0 ? ((x + 1) * m_cellSize - p0.x) / d.x
+                    : stepX < 0 ? (x * m_cellSize - p0.x) / d.x : inf;
+        float tMaxY = stepY > 0 ? ((y + 1) * m_cellSize - p0.y) / d.y
+                    : stepY < 0 ? (y * m_cellSize - p0.y) / d.y : inf;
+
+        // The block around the first cell, then the leading edge after every step
+        // (the walk only moves toward the end cell, so an edge is never seen twice)
+        visitCells(x - reach, x + reach, y - reach, y + reach);
+        while (remaining-- > 0) {
+            // Step along the axis whose border comes first, never past the end cell
+            bool stepAlongX = (y == endY) || (x != endX && tMaxX < tMaxY);
+            if (stepAlongX) {
+                x += stepX;
+                tMaxX += tDeltaX;
+                int edge = x + stepX * reach;
+                visitCells(edge, edge, y - reach, y + reach);
+            } else {
+                y += stepY;
+                tMaxY += tDeltaY;
+                int edge = y + stepY * reach;
+                visitCells(x - reach, x + reach, edge, edge);
+            }
+        }
+    }
+};
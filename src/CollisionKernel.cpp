@@ -0,0 +1,148 @@
+#include "CollisionKernel.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define COLLISION_KERNEL_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define COLLISION_KERNEL_NEON 1
+#endif
+
+namespace {
+
+using OverlapKernel = void (*)(float, float, float, const float*, const float*, const float*, size_t, uint8_t*);
+
+// Scalar fallback, also used for the tail of the vector kernels
+void overlapScalar(float qx, float qy, float qr,
+                   const float* xs, const float* ys, const float* rs,
+                   size_t count, uint8_t* hits) {
+    for (size_t i = 0; i < count; ++i) {
+        float dx = xs[i] - qx;
+        float dy = ys[i] - qy;
+        float reach = rs[i] + qr;
+        hits[i] = (dx * dx + dy * dy <= reach * reach) ? 1 : 0;
+    }
+}
+
+#if COLLISION_KERNEL_X86
+// 4 circles per instruction
+__attribute__((target("sse2")))
+void overlapSSE2(float qx, float qy, float qr,
+                 const float* xs, const float* ys, const float* rs,
+                 size_t count, uint8_t* hits) {
+    const __m128 px = _mm_set1_ps(qx);
+    const __m128 py = _mm_set1_ps(qy);
+    const __m128 pr = _mm_set1_ps(qr);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), px);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), py);
+        __m128 reach = _mm_add_ps(_mm_loadu_ps(rs + i), pr);
+        __m128 dist2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        int mask = _mm_movemask_ps(_mm_cmple_ps(dist2, _mm_mul_ps(reach, reach)));
+        for (int lane = 0; lane < 4; ++lane) {
+            hits[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+        }
+    }
+    overlapScalar(qx, qy, qr, xs + i, ys + i, rs + i, count - i, hits + i);
+}
+
+// Overlap bitmask for 8 circles starting at xs/ys/rs
+// Vector values stay inside AVX2-targeted code so no __m256 crosses an ABI boundary.
+__attribute__((target("avx2,fma")))
+inline unsigned overlapBlockAVX2(float qx, float qy, float qr,
+                                 const float* xs, const float* ys, const float* rs) {
+    __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs), _mm256_set1_ps(qx));
+    __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys), _mm256_set1_ps(qy));
+    __m256 reach = _mm256_add_ps(_mm256_loadu_ps(rs), _mm256_set1_ps(qr));
+    __m256 dist2 = _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dx, dx));
+    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(dist2, _mm256_mul_ps(reach, reach), _CMP_LE_OQ)));
+}
+
+// 8 circles per instruction, two blocks (16 circles) per iteration
+__attribute__((target("avx2,fma")))
+void overlapAVX2(float qx, float qy, float qr,
+                 const float* xs, const float* ys, const float* rs,
+                 size_t count, uint8_t* hits) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        unsigned mask = overlapBlockAVX2(qx, qy, qr, xs + i, ys + i, rs + i)
+                      | (overlapBlockAVX2(qx, qy, qr, xs + i + 8, ys + i + 8, rs + i + 8) << 8);
+        for (int lane = 0; lane < 16; ++lane) {
+            hits[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+        }
+    }
+    for (; i + 8 <= count; i += 8) {
+        unsigned mask = overlapBlockAVX2(qx, qy, qr, xs + i, ys + i, rs + i);
+        for (int lane = 0; lane < 8; ++lane) {
+            hits[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+        }
+    }
+    overlapScalar(qx, qy, qr, xs + i, ys + i, rs + i, count - i, hits + i);
+}
+#endif
+
+#if COLLISION_KERNEL_NEON
+// 4 circles per instruction (always available on arm64)
+void overlapNEON(float qx, float qy, float qr,
+                 const float* xs, const float* ys, const float* rs,
+                 size_t count, uint8_t* hits) {
+    const float32x4_t px = vdupq_n_f32(qx);
+    const float32x4_t py = vdupq_n_f32(qy);
+    const float32x4_t pr = vdupq_n_f32(qr);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t dx = vsubq_f32(vld1q_f32(xs + i), px);
+        float32x4_t dy = vsubq_f32(vld1q_f32(ys + i), py);
+        float32x4_t reach = vaddq_f32(vld1q_f32(rs + i), pr);
+        float32x4_t dist2 = vfmaq_f32(vmulq_f32(dx, dx), dy, dy);
+        uint32x4_t inside = vcleq_f32(dist2, vmulq_f32(reach, reach));
+        // Narrow the 32-bit lane masks to one byte per lane
+        uint16x4_t narrow16 = vmovn_u32(inside);
+        uint8x8_t narrow8 = vmovn_u16(vcombine_u16(narrow16, narrow16));
+        uint8x8_t ones = vand_u8(narrow8, vdup_n_u8(1));
+        vst1_lane_u32(reinterpret_cast<uint32_t*>(hits + i), vreinterpret_u32_u8(ones), 0);
+    }
+    overlapScalar(qx, qy, qr, xs + i, ys + i, rs + i, count - i, hits + i);
+}
+#endif
+
+struct KernelChoice {
+    OverlapKernel kernel;
+    const char* name;
+};
+
+KernelChoice selectKernel() {
+#if COLLISION_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return {overlapAVX2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return {overlapSSE2, "sse2"};
+    }
+#elif COLLISION_KERNEL_NEON
+    return {overlapNEON, "neon"};
+#endif
+    return {overlapScalar, "scalar"};
+}
+
+// Selected on first use and reused for the rest of the run
+const KernelChoice& kernelChoice() {
+    static const KernelChoice choice = selectKernel();
+    return choice;
+}
+
+} // namespace
+
+void circleOverlapMask(float qx, float qy, float qr,
+                       const float* xs, const float* ys, const float* rs,
+                       size_t count, uint8_t* hits) {
+    kernelChoice().kernel(qx, qy, qr, xs, ys, rs, count, hits);
+}
+
+const char* circleOverlapKernelName() {
+    return kernelChoice().name;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Packed candidate list for the narrow phase (structure of arrays)
+// Keeps x, y and radius in separate contiguous arrays so the overlap kernel
+// can load several circles per instruction.
+struct PackedCircles {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> radius;
+
+    void clear() {
+        x.clear();
+        y.clear();
+        radius.clear();
+    }
+
+    void push(float px, float py, float r) {
+        x.push_back(px);
+        y.push_back(py);
+        radius.push_back(r);
+    }
+
+    size_t size() const { return x.size(); }
+};
+
+// Tests one circle (qx, qy, qr) against count packed circles starting at xs/ys/rs
+// Writes hits[i] = 1 if the circles touch (squared distance <= squared radius sum), 0 otherwise.
+// The implementation (AVX2, SSE2, NEON or scalar) is selected once at runtime.
+void circleOverlapMask(float qx, float qy, float qr,
+                       const float* xs, const float* ys, const float* rs,
+                       size_t count, uint8_t* hits);
+
+// Name of the kernel selected at runtime (e.g. "avx2"), for logs and benchmarks
+const char* circleOverlapKernelName();
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "EntityManager.hpp"
+#include "Collision.hpp"
+#include "CollisionKernel.hpp"
+#include <algorithm>
+#include <array>
+#include <vector>
+
+// Broad and narrow phase for every layer pair the collision matrix enables
+// Each layer gets its own grid holding its colliders' swept bounds (start to
+// end of the step, grown by the radius), so pairs the matrix leaves out
+// (bullet-bullet, anything without a layer) are never generated. For each
+// query collider, candidates from the target layer's grid are packed and
+// filtered by the SIMD overlap kernel, then confirmed with the swept circle
+// test. The handler sees one query collider's contacts in time-of-impact
+// order and returns false to stop looking at the rest. Contacts involving a
+// polygon (CPolygon) are confirmed against the exact shape only after the
+// bounding circles touch, so most pairs cost no more than the circle test.
+class CollisionWorld {
+public:
+    CollisionMatrix matrix;
+
+    // Collects the colliders of every layer that interacts with something and fills their grids
+    void build(const EntityVec& entities, float worldWidth, float worldHeight, float cellSize) {
+        for (auto& layer : m_layers) {
+            layer.colliders.clear();
+        }
+        for (auto& entity : entities) {
+            const auto& collision = entity->get<CCollision>();
+            if (entity->isAlive() && collision.isCollidable && matrix.mask(collision.layer) != 0) {
+                m_layers[static_cast<size_t>(collision.layer)].colliders.push_back(entity);
+                auto& polygon = entity->get<CPolygon>();
+                if (polygon.isPolygon()) {
+                    polygon.refresh(entity->get<CRotation>().angle); // No-op unless it rotated
+                }
+            }
+        }
+
+        for (auto& layer : m_layers) {
+            layer.grid.reset(worldWidth, worldHeight, cellSize);
+            layer.lastQuery.assign(layer.colliders.size(), 0);
+            for (size_t i = 0; i < layer.colliders.size(); ++i) {
+                const auto& transform = layer.colliders[i]->get<CTransform>();
+                float radius = layer.colliders[i]->get<CCollision>().radius;
+                Vec2<float> min(std::min(transform.prevPosition.x, transform.position.x) - radius,
+                                std::min(transform.prevPosition.y, transform.position.y) - radius);
+                Vec2<float> max(std::max(transform.prevPosition.x, transform.position.x) + radius,
+                                std::max(transform.prevPosition.y, transform.position.y) + radius);
+                layer.grid.insert(i, min, max);
+            }
+        }
+    }
+
+    // Colliders on a layer, in the order build() found them (handler indices refer to these)
+    const EntityVec& colliders(CollisionLayer layer) const { return m_layers[static_cast<size_t>(layer)].colliders; }
+
+    // Tests every query collider against the target layer (each pair once when
+    // they are the same layer), calling onContact(queryIndex, targetIndex, toi).
+    // Returns the number of swept tests run.
+    template <typename OnContact>
+    size_t resolve(CollisionLayer query, CollisionLayer target, OnContact&& onContact) {
+        const EntityVec& queries = colliders(query);
+        size_t tests = 0;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            const auto& transform = queries[i]->get<CTransform>();
+            tests += sweepCircle(target, transform.prevPosition, transform.position,
+                                 queries[i]->get<CCollision>().radius, query == target ? i + 1 : 0,
+                                 [&](size_t j, float toi) { return onContact(i, j, toi); }, polygonOf(*queries[i]));
+        }
+        return tests;
+    }
+
+    // Tests a circle moving from -> to during the step (an entity or not) against
+    // the target layer's colliders from index firstTarget on, calling
+    // onContact(targetIndex, toi) earliest first. With a shape, the circle is
+    // only the bounds of that polygon. Returns the number of swept tests run.
+    template <typename OnContact>
+    size_t sweepCircle(CollisionLayer target, const Vec2<float>& from, const Vec2<float>& to, float radius,
+                       size_t firstTarget, OnContact&& onContact, const PolygonShape* shape = nullptr) {
+        Layer& layer = m_layers[static_cast<size_t>(target)];
+        const EntityVec& targets = layer.colliders;
+        ++m_query;
+
+        // Broad phase: targets sharing a cell with the swept circle
+        m_candidates.clear();
+        layer.grid.querySegment(from, to, radius, [&](size_t j) {
+            if (layer.lastQuery[j] != m_query && j >= firstTarget) {
+                layer.lastQuery[j] = m_query;
+                m_candidates.push_back(j);
+            }
+        });
+        if (m_candidates.empty()) {
+            return 0;
+        }
+
+        // Conservative overlap at the end of the step: radii grown by how far each moved
+        m_packed.clear();
+        for (size_t j : m_candidates) {
+            const auto& transform = targets[j]->get<CTransform>();
+            m_packed.push(transform.position.x, transform.position.y,
+                          targets[j]->get<CCollision>().radius + transform.position.distance(transform.prevPosition));
+        }
+        m_hits.resize(m_candidates.size());
+        circleOverlapMask(to.x, to.y, radius + to.distance(from),
+                          m_packed.x.data(), m_packed.y.data(), m_packed.radius.data(),
+                          m_candidates.size(), m_hits.data());
+
+        // Narrow phase: exact swept test, earliest contact first
+        size_t tests = 0;
+        m_contacts.clear();
+        for (size_t k = 0; k < m_candidates.size(); ++k) {
+            if (!m_hits[k]) {
+                continue;
+            }
+            ++tests;
+            const auto& targetTransform = targets[m_candidates[k]]->get<CTransform>();
+            float toi;
+            float targetRadius = targets[m_candidates[k]]->get<CCollision>().radius;
+            if (!sweptCircleCircle(from, to, targetTransform.prevPosition, targetTransform.position,
+                                   radius + targetRadius, toi)) {
+                continue;
+            }
+
+            // Bounding circles touch: confirm against the exact shapes
+            const PolygonShape* targetShape = polygonOf(*targets[m_candidates[k]]);
+            if (shape && targetShape) {
+                if (!polygonsOverlap(*shape, to, *targetShape, targetTransform.position)) {
+                    continue;
+                }
+            } else if (targetShape) {
+                // The circle's path relative to the target, ending where both are now
+                Vec2<float> start = from - targetTransform.prevPosition + targetTransform.position;
+                if (!sweptCirclePolygon(start, to, radius, *targetShape, targetTransform.position)) {
+                    continue;
+                }
+            } else if (shape) {
+                Vec2<float> start = targetTransform.prevPosition - from + to;
+                if (!sweptCirclePolygon(start, targetTransform.position, targetRadius, *shape, to)) {
+                    continue;
+                }
+            }
+            m_contacts.emplace_back(toi, m_candidates[k]);
+        }
+        std::sort(m_contacts.begin(), m_contacts.end());
+        for (const auto& [toi, j] : m_contacts) {
+            if (!onContact(j, toi)) {
+                break;
+            }
+        }
+        return tests;
+    }
+
+private:
+    // The entity's exact outline (cached by build), or null when it collides as a circle
+    static const PolygonShape* polygonOf(const Entity& entity) {
+        const auto& polygon = entity.get<CPolygon>();
+        return polygon.isPolygon() ? &polygon.shape : nullptr;
+    }
+
+    struct Layer {
+        EntityVec colliders;
+        SpatialGrid grid;
+        std::vector<uint64_t> lastQuery; // Query that last collected each collider (dedupes grid cells)
+    };
+
+    std::array<Layer, collisionLayerCount> m_layers;
+    uint64_t m_query = 0;             // Queries run so far
+    std::vector<size_t> m_candidates; // Target indices from the broad phase
+    PackedCircles m_packed;           // Candidates packed for the overlap kernel
+    std::vector<uint8_t> m_hits;      // Kernel output per candidate
+    std::vector<std::pair<float, size_t>> m_contacts; // Time of impact, target index
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "EntityManager.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Records structural changes (create, destroy, add component) instead of applying
+// them in the middle of a system's iteration. Commands run on flush(), at a sync
+// point chosen by the game loop, on the thread that owns the EntityManager.
+class CommandBuffer {
+    struct Create {
+        std::string tag;
+        std::function<void(const std::shared_ptr<Entity>&)> init; // Adds the new entity's components
+    };
+
+    std::vector<Create> m_creates;
+    std::vector<std::function<void()>> m_componentWrites;
+    std::vector<std::shared_ptr<Entity>> m_destroys;
+
+public:
+    // Create an entity with the given tag; init receives it to add components (or schedule timers on it)
+    void createEntity(const std::string& tag, std::function<void(const std::shared_ptr<Entity>&)> init) {
+        m_creates.push_back({tag, std::move(init)});
+    }
+
+    // Mark an entity as destroyed
+    void destroyEntity(const std::shared_ptr<Entity>& entity) {
+        m_destroys.push_back(entity);
+    }
+
+    // Add or replace a component on an existing entity
+    template <typename T, typename... Args>
+    void addComponent(const std::shared_ptr<Entity>& entity, Args&&... args) {
+        m_componentWrites.push_back([entity, component = T(std::forward<Args>(args)...)]() {
+            entity->add<T>(component);
+        });
+    }
+
+    bool empty() const {
+        return m_creates.empty() && m_componentWrites.empty() && m_destroys.empty();
+    }
+
+    // Apply all recorded commands in order: component writes, destroys, then creates
+    void flush(EntityManager& entityManager) {
+        for (auto& write : m_componentWrites) {
+            write();
+        }
+        for (auto& entity : m_destroys) {
+            entity->destroy();
+        }
+        for (auto& create : m_creates) {
+            auto entity = entityManager.addEntity(create.tag);
+            create.init(entity);
+        }
+        m_componentWrites.clear();
+        m_destroys.clear();
+        m_creates.clear();
+    }
+};
+
+// One command buffer per worker thread, so systems can record without locking
+// Flushed in worker order, which keeps entity IDs independent of thread timing.
+class CommandBuffers {
+    std::vector<CommandBuffer> m_buffers;
+
+public:
+    explicit CommandBuffers(size_t workers = 1) : m_buffers(workers) {}
+
+    // Buffer owned by the given worker (0 is the main thread)
+    CommandBuffer& operator[](size_t worker) { return m_buffers[worker]; }
+
+    size_t workers() const { return m_buffers.size(); }
+
+    void flush(EntityManager& entityManager) {
+        for (auto& buffer : m_buffers) {
+            buffer.flush(entityManager);
+        }
+    }
+};
@@ -0,0 +1,270 @@
+#pragma once
+
+#include "Entity.hpp"
+#include "Vec2.hpp"
+#include <SFML/Graphics/Color.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// === Compact Entity Storage ===
+// Storage for worlds too large for one Entity per shape (hundreds of bytes
+// and a heap allocation each). Every field is an array of its own, and only
+// what varies per entity is kept:
+//   cell     u32  grid cell (x in the low half, y in the high half)
+//   x, y     u16  position inside the cell in 1/256 pixel fixed point
+//   vx, vy   i16  velocity in 1/8 pixel per second (up to 4096 px/s)
+//   packed   u16  side count, type, color palette index and flags
+// which is 14 bytes per entity, plus 4 for the id. The cell is the high half
+// of a 32-bit fixed-point coordinate, so moving is integer arithmetic on
+// (cell << 16 | offset) and never loses precision far from the origin. The
+// radius comes from a per-type table and colors from a shared palette.
+
+enum class CompactType : uint8_t { Other, Player, Enemy, Bullet, Clone };
+
+constexpr size_t compactTypeCount = 8; // Types the packed word can hold
+
+inline CompactType compactTypeOf(const std::string& tag) {
+    if (tag == "player") return CompactType::Player;
+    if (tag == "enemy") return CompactType::Enemy;
+    if (tag == "bullet") return CompactType::Bullet;
+    if (tag == "clone") return CompactType::Clone;
+    return CompactType::Other;
+}
+
+// Up to 128 shared colors; when it is full, a new color maps to the nearest one
+class CompactPalette {
+public:
+    static constexpr size_t capacity = 128;
+
+    uint8_t index(const sf::Color& color) {
+        uint32_t rgba = color.toInteger();
+        for (size_t i = 0; i < m_colors.size(); ++i) {
+            if (m_colors[i] == rgba) {
+                return static_cast<uint8_t>(i);
+            }
+        }
+        if (m_colors.size() < capacity) {
+            m_colors.push_back(rgba);
+            return static_cast<uint8_t>(m_colors.size() - 1);
+        }
+        size_t best = 0;
+        int bestDistance = INT32_MAX;
+        for (size_t i = 0; i < m_colors.size(); ++i) {
+            sf::Color entry(m_colors[i]);
+            int dr = entry.r - color.r, dg = entry.g - color.g, db = entry.b - color.b, da = entry.a - color.a;
+            int distance = dr * dr + dg * dg + db * db + da * da;
+            if (distance < bestDistance) {
+                best = i;
+                bestDistance = distance;
+            }
+        }
+        return static_cast<uint8_t>(best);
+    }
+
+    sf::Color color(uint8_t index) const { return index < m_colors.size() ? sf::Color(m_colors[index]) : sf::Color::White; }
+    size_t size() const { return m_colors.size(); }
+    void clear() { m_colors.clear(); }
+
+private:
+    std::vector<uint32_t> m_colors; // RGBA
+};
+
+class CompactEntityStore {
+public:
+    static constexpr float cellSize = 256.0f;      // Pixels per cell: one cell is 65536 position steps
+    static constexpr float positionScale = 256.0f; // Position steps per pixel
+    static constexpr float velocityScale = 8.0f;   // Velocity steps per pixel per second
+    static constexpr float maxCoordinate = 32767.0f * cellSize; // Largest position (the fixed point is a signed 32-bit value)
+    static constexpr size_t bytesPerEntity = sizeof(uint32_t) + 2 * sizeof(uint16_t) + 2 * sizeof(int16_t) + sizeof(uint16_t);
+    static constexpr size_t bytesPerEntityWithId = bytesPerEntity + sizeof(uint32_t);
+
+    // Packed word: sides (0-31, larger is stored as 31) | type | palette | flags
+    static constexpr uint16_t sidesBits = 5, typeBits = 3, paletteBits = 7;
+    static constexpr uint16_t flagProtected = 1u << 15; // Spawn protection (CSpawnTime)
+
+    // === Storage ===
+    void reserve(size_t count) {
+        m_id.reserve(count);
+        m_cell.reserve(count);
+        m_x.reserve(count);
+        m_y.reserve(count);
+        m_vx.reserve(count);
+        m_vy.reserve(count);
+        m_packed.reserve(count);
+    }
+
+    void clear() {
+        m_id.clear();
+        m_cell.clear();
+        m_x.clear();
+        m_y.clear();
+        m_vx.clear();
+        m_vy.clear();
+        m_packed.clear();
+    }
+
+    size_t size() const { return m_id.size(); }
+
+    // Bytes held by the per-entity arrays (capacity, not size)
+    size_t memoryBytes() const {
+        return m_id.capacity() * sizeof(uint32_t) + m_cell.capacity() * sizeof(uint32_t) +
+               (m_x.capacity() + m_y.capacity()) * sizeof(uint16_t) +
+               (m_vx.capacity() + m_vy.capacity()) * sizeof(int16_t) + m_packed.capacity() * sizeof(uint16_t);
+    }
+
+    // Radius of every entity of a type (the collision and drawing radius)
+    void setRadius(CompactType type, float radius) { m_radius[static_cast<size_t>(type)] = radius; }
+
+    CompactPalette& palette() { return m_palette; }
+    const CompactPalette& palette() const { return m_palette; }
+
+    // === Adding and Removing ===
+    size_t add(uint32_t id, CompactType type, const Vec2<float>& position, const Vec2<float>& velocity,
+               int sides, const sf::Color& color, uint16_t flags = 0) {
+        m_id.push_back(id);
+        m_cell.push_back(0);
+        m_x.push_back(0);
+        m_y.push_back(0);
+        m_vx.push_back(0);
+        m_vy.push_back(0);
+        m_packed.push_back(static_cast<uint16_t>(std::clamp(sides, 0, (1 << sidesBits) - 1)) |
+                           static_cast<uint16_t>(static_cast<uint16_t>(type) << sidesBits) |
+                           static_cast<uint16_t>(m_palette.index(color) << (sidesBits + typeBits)) | flags);
+        size_t index = size() - 1;
+        setPosition(index, position);
+        setVelocity(index, velocity);
+        return index;
+    }
+
+    // Copies an entity's transform, shape and spawn protection
+    size_t add(const Entity& entity) {
+        const auto& transform = entity.get<CTransform>();
+        const auto& shape = entity.get<CShape>();
+        uint16_t flags = entity.get<CSpawnTime>().isProtected ? flagProtected : 0;
+        return add(static_cast<uint32_t>(entity.id()), compactTypeOf(entity.tag()), transform.position,
+                   transform.velocity, shape.sides, shape.color, flags);
+    }
+
+    // Removes by moving the last entity into index (order is not kept)
+    void remove(size_t index) {
+        size_t last = size() - 1;
+        m_id[index] = m_id[last];
+        m_cell[index] = m_cell[last];
+        m_x[index] = m_x[last];
+        m_y[index] = m_y[last];
+        m_vx[index] = m_vx[last];
+        m_vy[index] = m_vy[last];
+        m_packed[index] = m_packed[last];
+        m_id.pop_back();
+        m_cell.pop_back();
+        m_x.pop_back();
+        m_y.pop_back();
+        m_vx.pop_back();
+        m_vy.pop_back();
+        m_packed.pop_back();
+    }
+
+    // === Fields ===
+    uint32_t id(size_t i) const { return m_id[i]; }
+    uint32_t cell(size_t i) const { return m_cell[i]; }
+
+    Vec2<float> position(size_t i) const {
+        return Vec2<float>(static_cast<float>(fixedX(i)) / positionScale, static_cast<float>(fixedY(i)) / positionScale);
+    }
+
+    // Clamped to [0, maxCoordinate] and rounded to the nearest step
+    void setPosition(size_t i, const Vec2<float>& position) {
+        store(i, toFixed(position.x), toFixed(position.y));
+    }
+
+    Vec2<float> velocity(size_t i) const {
+        return Vec2<float>(m_vx[i] / velocityScale, m_vy[i] / velocityScale);
+    }
+
+    void setVelocity(size_t i, const Vec2<float>& velocity) {
+        m_vx[i] = toVelocity(velocity.x);
+        m_vy[i] = toVelocity(velocity.y);
+    }
+
+    int sides(size_t i) const { return m_packed[i] & ((1u << sidesBits) - 1); }
+    CompactType type(size_t i) const { return static_cast<CompactType>(m_packed[i] >> sidesBits & ((1u << typeBits) - 1)); }
+    float radius(size_t i) const { return m_radius[static_cast<size_t>(type(i))]; }
+    sf::Color color(size_t i) const { return m_palette.color(static_cast<uint8_t>(m_packed[i] >> (sidesBits + typeBits) & ((1u << paletteBits) - 1))); }
+    bool hasFlag(size_t i, uint16_t flag) const { return (m_packed[i] & flag) != 0; }
+
+    void setFlag(size_t i, uint16_t flag, bool on) {
+        m_packed[i] = static_cast<uint16_t>(on ? m_packed[i] | flag : m_packed[i] & ~flag);
+    }
+
+    // Writes the stored state back into an entity's components
+    void unpack(size_t i, Entity& entity) const {
+        auto& transform = entity.get<CTransform>();
+        transform.position = position(i);
+        transform.prevPosition = transform.position;
+        transform.velocity = velocity(i);
+        auto& shape = entity.modify<CShape>();
+        shape.sides = sides(i);
+        shape.radius = radius(i);
+        shape.color = color(i);
+        entity.get<CCollision>().radius = shape.radius;
+        entity.modify<CSpawnTime>().isProtected = hasFlag(i, flagProtected);
+    }
+
+    // === Simulation ===
+    // Moves every entity by its velocity for dt seconds, reversing a velocity
+    // component when the entity's edge reaches the world bounds (like enemies do)
+    void integrate(float dt, float worldWidth, float worldHeight) {
+        // Velocity steps to position steps in 16.16 fixed point, so the whole update is integer math
+        const int64_t stepScale = std::llrint(static_cast<double>(dt) * positionScale / velocityScale * 65536.0);
+        const int32_t right = toFixed(worldWidth), bottom = toFixed(worldHeight);
+        std::array<int32_t, compactTypeCount> radii;
+        for (size_t type = 0; type < compactTypeCount; ++type) {
+            radii[type] = toFixed(m_radius[type]);
+        }
+        const size_t count = size();
+        for (size_t i = 0; i < count; ++i) {
+            int32_t x = fixedX(i) + static_cast<int32_t>((m_vx[i] * stepScale + 0x8000) >> 16);
+            int32_t y = fixedY(i) + static_cast<int32_t>((m_vy[i] * stepScale + 0x8000) >> 16);
+            int32_t r = radii[m_packed[i] >> sidesBits & ((1u << typeBits) - 1)];
+            if (x - r <= 0 || x + r >= right) {
+                m_vx[i] = static_cast<int16_t>(-m_vx[i]);
+            }
+            if (y - r <= 0 || y + r >= bottom) {
+                m_vy[i] = static_cast<int16_t>(-m_vy[i]);
+            }
+            store(i, std::max(x, 0), std::max(y, 0));
+        }
+    }
+
+private:
+    int32_t fixedX(size_t i) const { return static_cast<int32_t>((m_cell[i] & 0xFFFFu) << 16 | m_x[i]); }
+    int32_t fixedY(size_t i) const { return static_cast<int32_t>((m_cell[i] & 0xFFFF0000u) | m_y[i]); }
+
+    static int32_t toFixed(float coordinate) {
+        return static_cast<int32_t>(std::lrint(std::clamp(coordinate, 0.0f, maxCoordinate) * positionScale));
+    }
+
+    static int16_t toVelocity(float velocity) {
+        return static_cast<int16_t>(std::lrint(std::clamp(velocity * velocityScale, -32767.0f, 32767.0f)));
+    }
+
+    void store(size_t i, int32_t x, int32_t y) {
+        m_cell[i] = static_cast<uint32_t>(x >> 16) | static_cast<uint32_t>(y >> 16) << 16;
+        m_x[i] = static_cast<uint16_t>(x);
+        m_y[i] = static_cast<uint16_t>(y);
+    }
+
+    // === Per-entity fields (SoA) ===
+    std::vector<uint32_t> m_id;
+    std::vector<uint32_t> m_cell;      // Cell x | cell y << 16
+    std::vector<uint16_t> m_x, m_y;    // Position inside the cell
+    std::vector<int16_t> m_vx, m_vy;   // Velocity
+    std::vector<uint16_t> m_packed;    // Sides | type | palette index | flags
+
+    std::array<float, compactTypeCount> m_radius{}; // Radius per CompactType
+    CompactPalette m_palette;
+};
@@ -1,19 +1,21 @@
 #pragma once
 
 #include "Vec2.hpp"
+#include "Collision.hpp"
+#include "PolygonGeometry.hpp"
+#include <limits>
 #include <string>
 #include <SFML/Graphics/Color.hpp>
 
-// Transform component: stores position, velocity, and scale
+// Transform component: stores position and velocity
 struct CTransform {
     Vec2<float> position;   // Entity's position
     Vec2<float> velocity;   // Entity's velocity
-    Vec2<float> scale = {1.0f, 1.0f}; // Scale (default is 1.0)
+    Vec2<float> prevPosition; // Position at the start of the last step (for swept collision)
 
     CTransform(const Vec2<float>& pos = {0.0f, 0.0f},
-               const Vec2<float>& vel = {0.0f, 0.0f},
-               const Vec2<float>& scl = {1.0f, 1.0f})
-        : position(pos), velocity(vel), scale(scl) {}
+               const Vec2<float>& vel = {0.0f, 0.0f})
+        : position(pos), velocity(vel), prevPosition(pos) {}
 };
 
 struct CShape {
@@ -26,10 +28,10 @@ struct CShape {
 };
 
 struct CState {
-    bool isInvincible = false; // True if the player is invincible
-    float invincibilityTimer = 0.0f; // Remaining invincibility duration
+    bool isInvincible = false; // True if the player is invincible (cleared by a timer)
+    double invincibleUntil = 0.0; // Game time at which invincibility ends
     CState() = default; // Default constructor
-    CState(bool i, float t) : isInvincible(i), invincibilityTimer(t) {}
+    CState(bool i, double until) : isInvincible(i), invincibleUntil(until) {}
 };
 
 struct CRotation {
@@ -41,17 +43,19 @@ struct CRotation {
 };
 
 // Time-based lifespan: how long an entity stays alive in seconds
+// (expiry is a timer scheduled when the entity is created)
 struct CLifeSpan {
-    float remainingTime; // Remaining time (in seconds)
     float totalTime;     // Total lifespan
 
-    CLifeSpan(float life = 0) : remainingTime(life), totalTime(life) {}
+    CLifeSpan(float life = 0) : totalTime(life) {}
 };
 
+// Spawn protection: new enemies cannot hurt the player until a timer clears it
 struct CSpawnTime {
-    float timeSinceSpawn;
+    double spawnedAt;        // Game time of the spawn
+    bool isProtected = true; // Still inside the protection window
 
-    CSpawnTime(float spawnTime = 0.0f) : timeSinceSpawn(spawnTime) {}
+    CSpawnTime(double spawnTime = 0.0) : spawnedAt(spawnTime) {}
 };
 
 // Count-based lives: for entities like players
@@ -62,24 +66,67 @@ struct CLives {
     CLives(int lives = 0) : remaining(lives), total(lives) {}
 };
 
-// Input component: stores movement flags for entities controlled by input
+// Input component: stores movement flags and action requests for entities controlled by input
 struct CInput {
     bool up = false;
     bool down = false;
     bool left = false;
     bool right = false;
+    bool fire = false;        // Fire a bullet toward aim this update
+    bool supermove = false;   // Trigger the supermove this update
+    Vec2<float> aim;          // Aim point in world coordinates
+    Vec2<float> move;         // Average movement direction over the update (each axis in [-1, 1])
+    float fireTime = 0.0f;    // When in the update fire was pressed (0 = start, 1 = end)
+    float supermoveTime = 0.0f; // When in the update the supermove was pressed
+    int slot = 0;             // Which session player controls this entity
 
     CInput() = default;
+    CInput(int s) : slot(s) {}
+};
+
+// Weapon component: per-player bullet and supermove cooldowns
+// Cooldowns are stored as the game time they end, so nothing counts them down.
+struct CWeapon {
+    double shotReadyTime = 0.0;      // Game time the next normal bullet may fire
+    float supermoveCooldown = 4.0f;  // Time between supermove uses
+    double supermoveReadyTime = 0.0; // Game time the supermove is ready again
+
+    CWeapon() = default;
+    CWeapon(float supermove) : supermoveCooldown(supermove) {}
 };
 
 struct CCollision {
-    float radius;           // Collision radius
-    bool isCollidable;      // Whether the entity can collide with others
-    bool isTrigger;         // If true, this will only detect collisions without affecting physics
+    float radius = 0.0f;    // Collision radius
+    CollisionLayer layer = CollisionLayer::None; // Layer checked against the collision matrix
+    bool isCollidable = false; // Whether the entity can collide with others
+    bool isTrigger = false; // If true, this will only detect collisions without affecting physics
 
    CCollision() = default; // Default constructor
-   CCollision(float r, bool collidable = true, bool trigger = false)
-        : radius(r), isCollidable(collidable), isTrigger(trigger) {}
+   CCollision(float r, CollisionLayer l, bool collidable = true, bool trigger = false)
+        : radius(r), layer(l), isCollidable(collidable), isTrigger(trigger) {}
+};
+
+// Exact collision outline for 3-8 sided shapes (others collide as their circle)
+// The rotated corners and edge normals are cached and rebuilt only when the
+// angle they were built for differs from the one asked for.
+struct CPolygon {
+    int sides = 0;          // 0: not a polygon
+    float radius = 0.0f;    // Corner distance (the same as the bounding circle)
+    float builtAngle = std::numeric_limits<float>::quiet_NaN(); // Angle the cache holds (degrees)
+    PolygonShape shape;
+
+    CPolygon() = default;
+    CPolygon(int s, float r) : sides(s), radius(r) {}
+
+    bool isPolygon() const { return sides >= 3 && sides <= maxPolygonSides; }
+
+    const PolygonShape& refresh(float angle) {
+        if (angle != builtAngle) {
+            shape.build(sides, radius, angle);
+            builtAngle = angle;
+        }
+        return shape;
+    }
 };
 
 struct CBullet {
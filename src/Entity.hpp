@@ -1,13 +1,41 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
 #include <tuple>
 #include <string>
+#include <type_traits>
 #include "Components.hpp"
 
 // Alias for the tuple that holds all possible components an entity can have
 using ComponentTuple = std::tuple<
     CTransform, CLifeSpan, CLives, CInput, CShape,
-    CRotation, CCollision, CState, CBullet, CSpawnTime
+    CRotation, CCollision, CState, CBullet, CSpawnTime, CWeapon, CPolygon
 >;
 
+constexpr size_t componentCount = std::tuple_size_v<ComponentTuple>;
+
+// Position of a component type in ComponentTuple (its change-tracking bit)
+template <typename T, typename... Ts>
+constexpr size_t componentIndexIn(std::tuple<Ts...>*) {
+    size_t index = 0;
+    ((std::is_same_v<T, Ts> || (++index, false)) || ...);
+    return index;
+}
+
+template <typename T>
+constexpr size_t componentIndex = componentIndexIn<T>(static_cast<ComponentTuple*>(nullptr));
+
+// Components whose in-place writes all go through modify() or markChanged(),
+// so changedSince() sees every change. The rest (CTransform, CRotation, ...)
+// are written through get() every update and are not tracked; asking whether
+// one of them changed does not compile.
+template <typename T>
+constexpr bool isTrackedComponent = std::is_same_v<T, CLives> || std::is_same_v<T, CShape> ||
+                                    std::is_same_v<T, CState> || std::is_same_v<T, CSpawnTime> ||
+                                    std::is_same_v<T, CWeapon>;
+
 // Entity class: Represents an object in the game world with components and metadata
 class Entity {
 private:
@@ -15,6 +43,8 @@ private:
     bool m_alive = true;           // Tracks if the entity is active or destroyed
     std::string m_tag = "default"; // Entity type (e.g., "player", "enemy")
     size_t m_id = 0;               // Unique identifier for the entity
+    uint32_t m_dirty = 0;          // Components changed since the EntityManager last committed (one bit each)
+    std::array<uint64_t, componentCount> m_changedTick{}; // EntityManager tick that committed each component's last change
 
 public:
     // === Constructor ===
@@ -42,6 +72,9 @@ public:
     void add(Args&&... args) {
         // Constructs the component in-place with provided arguments
         std::get<T>(m_components) = T(std::forward<Args>(args)...);
+        if constexpr (isTrackedComponent<T>) {
+            markChanged<T>();
+        }
     }
 
     // Retrieves a mutable reference to a specific component
@@ -55,4 +88,37 @@ public:
     const T& get() const {
         return std::get<T>(m_components);
     }
+
+    // === Change Tracking ===
+    // get() does not track writes; tracked components (isTrackedComponent) are
+    // written through modify() or followed by markChanged()
+    template <typename T>
+    T& modify() {
+        markChanged<T>();
+        return std::get<T>(m_components);
+    }
+
+    template <typename T>
+    void markChanged() {
+        static_assert(isTrackedComponent<T>, "Only tracked components record changes (see isTrackedComponent)");
+        m_dirty |= 1u << componentIndex<T>;
+    }
+
+    // True if the component changed after the given EntityManager tick,
+    // including changes the manager has not committed yet
+    template <typename T>
+    bool changedSince(uint64_t tick) const {
+        static_assert(isTrackedComponent<T>, "Only tracked components record changes (see isTrackedComponent)");
+        return (m_dirty >> componentIndex<T> & 1u) || m_changedTick[componentIndex<T>] > tick;
+    }
+
+    // Stamps pending changes with the manager's tick
+    void commitChanges(uint64_t tick) {
+        for (uint32_t bits = m_dirty; bits != 0; bits &= bits - 1) {
+            m_changedTick[static_cast<size_t>(std::countr_zero(bits))] = tick;
+        }
+        m_dirty = 0;
+    }
 };
+
+static_assert(componentCount <= 32, "Change tracking keeps one bit per component type");
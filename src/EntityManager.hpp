@@ -10,11 +10,46 @@
 using EntityVec = std::vector<std::shared_ptr<Entity>>;
 using EntityMap = std::map<std::string, EntityVec>;
 
+// Z-order (Morton) key of a position: the bits of its x and y grid cells
+// interleaved, so positions close on screen mostly get close keys
+inline uint32_t mortonKey(const Vec2<float>& position, float cellSize) {
+    auto spread = [](float coordinate) {
+        uint32_t v = static_cast<uint32_t>(std::clamp(coordinate, 0.0f, 65535.0f));
+        v = (v | (v << 8)) & 0x00FF00FFu;
+        v = (v | (v << 4)) & 0x0F0F0F0Fu;
+        v = (v | (v << 2)) & 0x33333333u;
+        v = (v | (v << 1)) & 0x55555555u;
+        return v;
+    };
+    return spread(position.x / cellSize) | (spread(position.y / cellSize) << 1);
+}
+
 class EntityManager {
     EntityVec m_entities;    // Stores all entities
     EntityVec m_toAdd;       // Temporary storage for entities to be added
     EntityMap m_entityMap;   // Maps tags to groups of entities
     size_t m_totalEntities = 0; // Counter for unique entity IDs
+    uint64_t m_tick = 0;        // Number of update() calls; change stamps refer to it
+    uint32_t m_sortInterval = 0;   // Updates between spatial sorts of one group (0 = off)
+    float m_sortCellSize = 1.0f;   // Grid cell the Morton key is computed on
+    size_t m_sortCursor = 0;       // Next group: 0 = all entities, then the tag groups in order
+    std::vector<std::pair<uint32_t, uint32_t>> m_sortKeys; // Sort scratch: Morton key, index
+    EntityVec m_sortScratch;
+
+    // Reorders a group by the Morton key of each entity's position (ties keep their order)
+    void sortSpatially(EntityVec& group) {
+        m_sortKeys.clear();
+        for (size_t i = 0; i < group.size(); ++i) {
+            m_sortKeys.emplace_back(mortonKey(group[i]->get<CTransform>().position, m_sortCellSize),
+                                    static_cast<uint32_t>(i));
+        }
+        std::sort(m_sortKeys.begin(), m_sortKeys.end());
+        m_sortScratch.clear();
+        for (const auto& [key, index] : m_sortKeys) {
+            m_sortScratch.push_back(std::move(group[index]));
+        }
+        group.swap(m_sortScratch);
+    }
 
 public:
     // Add a new entity with a given tag
@@ -32,6 +67,14 @@ public:
         }
         m_toAdd.clear();
 
+        // Commit changes made since the last update (new entities count their added components)
+        ++m_tick;
+        for (auto& entity : m_entities) {
+            if (entity->isAlive()) {
+                entity->commitChanges(m_tick);
+            }
+        }
+
         // Remove dead entities from m_entities
         m_entities.erase(
             std::remove_if(m_entities.begin(), m_entities.end(),
@@ -47,6 +90,26 @@ public:
                 vec.end()
             );
         }
+
+        // Spatial compaction, one group at a time so no single update pays for all of them
+        if (m_sortInterval != 0 && m_tick % m_sortInterval == 0) {
+            m_sortCursor %= m_entityMap.size() + 1;
+            sortSpatially(m_sortCursor == 0 ? m_entities : std::next(m_entityMap.begin(), m_sortCursor - 1)->second);
+            ++m_sortCursor;
+        }
+    }
+
+    // === Spatial Ordering ===
+    // Every interval updates, one group (all entities, then each tag) is
+    // re-sorted into Z-order of CTransform positions on a cellSize grid, so
+    // loops over a group visit neighbours one after another. Entities keep
+    // their handles and IDs; only the order of the vectors changes (and so
+    // storage order no longer follows IDs). Entities added since the last
+    // sort of their group sit at its end. The order only depends on positions
+    // and the update count, so lockstep peers stay identical.
+    void setSpatialSort(uint32_t interval, float cellSize) {
+        m_sortInterval = interval;
+        m_sortCellSize = std::max(cellSize, 1.0f);
     }
 
     // Retrieve all entities
@@ -55,6 +118,11 @@ public:
     // Retrieve entities by tag
     EntityVec& getEntities(const std::string& tag) { return m_entityMap[tag]; }
 
+    // === Change Tracking ===
+    // Current tick: the number of update() calls so far. Consumers remember the
+    // tick they last looked at and ask Entity::changedSince (tracked components only)
+    uint64_t tick() const { return m_tick; }
+
     size_t countEntities(const std::string& tag) const {
         auto it = m_entityMap.find(tag);
         if (it != m_entityMap.end()) {
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Vec2.hpp"
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include <SFML/Graphics/Color.hpp>
+
+// === Gameplay Events ===
+// Events carry copies of the data consumers need, so they stay valid after the
+// entities involved are destroyed at the next sync point.
+
+// bulletId of a bullet that belongs to a pattern rather than being an entity
+inline constexpr size_t patternBulletId = static_cast<size_t>(-1);
+
+// An enemy was hit by a bullet
+struct EnemyKilled {
+    size_t enemyId;        // ID of the destroyed enemy
+    size_t bulletId;       // ID of the bullet that hit it (patternBulletId for pattern bullets)
+    Vec2<float> position;  // Enemy position at the time of the hit
+    float radius;          // Enemy radius
+    int sides;             // Enemy shape sides (drives score and fragment count)
+    sf::Color color;       // Enemy color (inherited by fragments)
+};
+
+// A player touched an enemy while vulnerable
+struct PlayerHit {
+    size_t playerId;       // ID of the player that was hit
+    size_t enemyId;        // ID of the enemy it touched
+};
+
+// A bullet reached the end of its lifespan without hitting anything
+struct BulletExpired {
+    size_t bulletId;       // ID of the expired bullet
+    Vec2<float> position;  // Where it expired
+};
+
+class Entity;
+
+// A timer scheduled on the timing wheel ran out (delivered by Game::handleTimer)
+struct TimerExpired {
+    enum Kind : uint8_t {
+        BulletLifespan,  // Destroy the bullet
+        Invincibility,   // End the player's invincibility
+        SpawnProtection  // The enemy can now hurt players
+    };
+    Kind kind;
+    std::weak_ptr<Entity> entity; // Ignored if the entity is already gone
+};
+
+// Append-only queue of one event type, drained once per frame
+template <typename T>
+class EventQueue {
+    std::vector<T> m_events;
+
+public:
+    void emit(const T& event) { m_events.push_back(event); }
+
+    const std::vector<T>& events() const { return m_events; }
+
+    bool empty() const { return m_events.empty(); }
+
+    // Move all events of another queue to the end of this one
+    void append(EventQueue& other) {
+        m_events.insert(m_events.end(), other.m_events.begin(), other.m_events.end());
+        other.clear();
+    }
+
+    void clear() { m_events.clear(); }
+};
+
+// One queue per event type, looked up by type like the entity component tuple
+// Each worker thread writes to its own EventBus; buses are merged with append()
+// at the sync point, in worker order, so consumers see a deterministic sequence.
+class EventBus {
+    std::tuple<EventQueue<EnemyKilled>, EventQueue<PlayerHit>, EventQueue<BulletExpired>> m_queues;
+
+public:
+    template <typename T>
+    void emit(const T& event) { std::get<EventQueue<T>>(m_queues).emit(event); }
+
+    template <typename T>
+    const std::vector<T>& get() const { return std::get<EventQueue<T>>(m_queues).events(); }
+
+    // Move all events of another bus into this one
+    void append(EventBus& other) {
+        std::apply([&](auto&... queues) {
+            (queues.append(std::get<std::remove_reference_t<decltype(queues)>>(other.m_queues)), ...);
+        }, m_queues);
+    }
+
+    // Drop all events (called after every consumer has run)
+    void clear() {
+        std::apply([](auto&... queues) { (queues.clear(), ...); }, m_queues);
+    }
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "LatencyHistogram.hpp"
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Frame timing distributions for soak runs
+struct FrameStats {
+    LatencyHistogram frame;          // Time between consecutive frames
+    LatencyHistogram simulation;     // update / lockstep ticks
+    LatencyHistogram render;         // render() including display
+    LatencyHistogram inputToPresent; // Oldest input event of a frame until that frame is displayed
+
+    // Histogram by report name (frame, sim, render, input), or nullptr
+    const LatencyHistogram* find(const std::string& name) const {
+        if (name == "frame") return &frame;
+        if (name == "sim") return &simulation;
+        if (name == "render") return &render;
+        if (name == "input") return &inputToPresent;
+        return nullptr;
+    }
+
+    // One row per histogram, in milliseconds
+    void print(std::ostream& out) const {
+        out << "metric       count      mean       p50       p99     p99.9       max  (ms)\n";
+        auto row = [&](const char* name, const LatencyHistogram& histogram) {
+            auto ms = [](double micros) { return micros / 1000.0; };
+            out << std::left << std::setw(8) << name << std::right
+                << std::setw(10) << histogram.count() << std::fixed << std::setprecision(3)
+                << std::setw(10) << ms(histogram.mean())
+                << std::setw(10) << ms(static_cast<double>(histogram.percentile(50.0)))
+                << std::setw(10) << ms(static_cast<double>(histogram.percentile(99.0)))
+                << std::setw(10) << ms(static_cast<double>(histogram.percentile(99.9)))
+                << std::setw(10) << ms(static_cast<double>(histogram.max())) << "\n";
+        };
+        row("frame", frame);
+        row("sim", simulation);
+        row("render", render);
+        row("input", inputToPresent);
+    }
+
+    bool writeFile(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file) {
+            std::cerr << "Failed to write latency report: " << path << std::endl;
+            return false;
+        }
+        print(file);
+        return true;
+    }
+};
+
+// Tail-latency limit such as "frame:p99=20" (percentile of a metric, in milliseconds)
+struct LatencyBudget {
+    std::string metric;
+    double percentile = 99.0; // "max" is stored as 100
+    double limitMs = 0.0;
+};
+
+// Parses a comma separated list of budgets, e.g. "frame:p99=20,input:p99.9=50,render:max=30"
+// Malformed entries are reported and skipped.
+inline std::vector<LatencyBudget> parseLatencyBudgets(const std::string& spec) {
+    std::vector<LatencyBudget> budgets;
+    std::stringstream entries(spec);
+    std::string entry;
+    while (std::getline(entries, entry, ',')) {
+        auto colon = entry.find(':');
+        auto equals = entry.find('=');
+        if (colon == std::string::npos || equals == std::string::npos || equals < colon) {
+            std::cerr << "Ignoring latency budget: " << entry << "\n";
+            continue;
+        }
+
+        LatencyBudget budget;
+        budget.metric = entry.substr(0, colon);
+        std::string quantile = entry.substr(colon + 1, equals - colon - 1);
+        if (quantile == "max") {
+            budget.percentile = 100.0;
+        } else if (quantile.size() > 1 && quantile[0] == 'p') {
+            budget.percentile = std::atof(quantile.c_str() + 1);
+        } else {
+            std::cerr << "Ignoring latency budget: " << entry << "\n";
+            continue;
+        }
+        budget.limitMs = std::atof(entry.c_str() + equals + 1);
+        budgets.push_back(budget);
+    }
+    return budgets;
+}
+
+// Prints every budget that the recorded distributions exceed; true when all pass
+inline bool checkLatencyBudgets(const FrameStats& stats, const std::vector<LatencyBudget>& budgets, std::ostream& out) {
+    bool passed = true;
+    for (const auto& budget : budgets) {
+        const LatencyHistogram* histogram = stats.find(budget.metric);
+        if (!histogram) {
+            out << "Unknown latency metric: " << budget.metric << "\n";
+            passed = false;
+            continue;
+        }
+
+        double valueMs = static_cast<double>(budget.percentile >= 100.0 ? histogram->max()
+                                                                         : histogram->percentile(budget.percentile)) / 1000.0;
+        if (valueMs > budget.limitMs) {
+            out << "Latency budget exceeded: " << budget.metric << " p" << budget.percentile
+                << " = " << valueMs << " ms (limit " << budget.limitMs << " ms)\n";
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+// === Report Signals ===
+// SIGUSR1 asks the game loop to write the latency report without stopping;
+// SIGINT/SIGTERM ask it to shut down cleanly so the exit report still runs.
+inline volatile std::sig_atomic_t latencyReportRequested = 0;
+inline volatile std::sig_atomic_t shutdownRequested = 0;
+
+inline void installLatencySignalHandlers() {
+    std::signal(SIGUSR1, [](int) { latencyReportRequested = 1; });
+    std::signal(SIGINT, [](int) { shutdownRequested = 1; });
+    std::signal(SIGTERM, [](int) { shutdownRequested = 1; });
+}
@@ -1,194 +1,842 @@
 #include "ScoreManager.hpp"
 #include "Game.h"
+#include "GameEnv.h"
 #include <iostream>
+#include <unordered_map>
+
+sf::Color getRandomBrightColor(RandomStream& random) {
+    // One draw: three 7-bit components in the bright range 128-255
+    uint32_t bits = random.next();
+    int r = 128 + static_cast<int>(bits & 127);
+    int g = 128 + static_cast<int>((bits >> 7) & 127);
+    int b = 128 + static_cast<int>((bits >> 14) & 127);
+
+    // Too dark overall (about 1 in 2600): mirror each component within the
+    // range, which always lands well above the limit
+    if (r + g + b < 400) {
+        r = 383 - r;
+        g = 383 - g;
+        b = 383 - b;
+    }
+    return sf::Color(r, g, b);
+}
 
-sf::Color getRandomBrightColor() {
-    int r, g, b;
+// Filled polygon with an outline grown outward by thickness (like sf::CircleShape), as triangles
+static void appendOutlinedPolygon(std::vector<sf::Vertex>& out, const Vec2<float>& center, const PolygonShape& polygon,
+                                  float thickness, const sf::Color& fill, const sf::Color& outline) {
+    sf::Vector2f middle(center.x, center.y);
+    float grow = thickness / (polygon.normals[0].x * polygon.vertices[0].x + polygon.normals[0].y * polygon.vertices[0].y); // Per apothem
+    for (int k = 0; k < polygon.sides; ++k) {
+        const Vec2<float>& a = polygon.vertices[k];
+        const Vec2<float>& b = polygon.vertices[(k + 1) % polygon.sides];
+        sf::Vector2f in0(center.x + a.x, center.y + a.y), in1(center.x + b.x, center.y + b.y);
+        sf::Vector2f out0(center.x + a.x * (1.0f + grow), center.y + a.y * (1.0f + grow));
+        sf::Vector2f out1(center.x + b.x * (1.0f + grow), center.y + b.y * (1.0f + grow));
+        out.emplace_back(middle, fill);
+        out.emplace_back(in0, fill);
+        out.emplace_back(in1, fill);
+        out.emplace_back(in0, outline);
+        out.emplace_back(out0, outline);
+        out.emplace_back(out1, outline);
+        out.emplace_back(in0, outline);
+        out.emplace_back(out1, outline);
+        out.emplace_back(in1, outline);
+    }
+}
 
-    do {
-        r = getRandom<int>(128, 255); // Red component (bright range)
-        g = getRandom<int>(128, 255); // Green component (bright range)
-        b = getRandom<int>(128, 255); // Blue component (bright range)
-    } while (r + g + b < 400); // Ensure it's not too dark overall 
+Game::Game(const GameOptions& gameOptions)
+    : options(gameOptions) {
+    // Which collision layers interact; handleContact holds the responses
+    collisionWorld.matrix.enable(CollisionLayer::Player, CollisionLayer::Enemy);
+    collisionWorld.matrix.enable(CollisionLayer::Enemy, CollisionLayer::Enemy);
+    collisionWorld.matrix.enable(CollisionLayer::Bullet, CollisionLayer::Enemy);
+
+    // Keep entity groups in Z-order so collision and render loops visit neighbours together
+    entityManager.setSpatialSort(options.spatialSortInterval, collisionCellSize);
+
+    // Simulation-only instances (batched training environments, see GameEnv.h)
+    // have no window, input, HUD or score file and are driven through
+    // resetEpisode/stepEpisode instead of run()
+    if (options.simulationOnly) {
+        spawnPlayer(0);
+        startWaveScripts();
+        return;
+    }
 
-    return sf::Color(r, g, b);
-}
+    // Headless runs have no window, input, HUD or frames to protect
+    if (!options.headless) {
+        window = std::make_unique<sf::RenderWindow>(
+            sf::VideoMode(static_cast<unsigned>(worldWidth), static_cast<unsigned>(worldHeight)), "ECS Game");
+        startupTimeline.mark("window");
+        quality.setBudget(options.frameBudgetMs);
+    }
 
-Game::Game()
-    : window(sf::VideoMode(1200, 700), "ECS Game") {
-    window.setFramerateLimit(60);
+    if (!options.latencyReport.empty() || !options.latencyBudget.empty()) {
+        installLatencySignalHandlers();
+    }
+    if (options.bot) {
+        bot = std::make_unique<BotController>(options.botSeed);
+        if (!options.soakLog.empty()) {
+            soakRecorder.open(options.soakLog, 1.0f);
+        }
+    }
 
-    // Seed the random number generator once
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
+    if (!options.telemetryPath.empty()) {
+        telemetry.open(options.telemetryPath, options.telemetryInterval);
+    }
 
     // Load best scores from file
     loadBestScores("shape_scores.txt", bestScores);
+    startupTimeline.mark("scores");
 
     // Initialize the HUD 
-    initializeHUD();
-    initializeGameOverText();
+    if (window) {
+        initializeHUD();
+        initializeGameOverText();
+        startupTimeline.mark("hud");
+    }
+
+    if (options.hostPort != 0 || !options.joinAddress.empty()) {
+        // Players are spawned once everyone has joined and the session seed is known
+        session = std::make_unique<LockstepSession>();
+        bool opened = options.hostPort != 0 ? session->host(options.hostPort, options.players)
+                                            : session->join(options.joinAddress);
+        if (!opened) {
+            std::cerr << "Failed to open network session" << std::endl;
+            session.reset();
+        }
+    }
+    if (session) {
+        // Iteration order is part of the simulation: every peer sorts on the same ticks
+        entityManager.setSpatialSort(GameOptions().spatialSortInterval, collisionCellSize);
+    }
+
+    if (!session) {
+        // Seed the random number generator once
+        seedRandom(static_cast<uint64_t>(std::time(nullptr)));
+        spawnPlayer(0);
+    }
+    startWaveScripts();
+    startupTimeline.mark("player");
+}
+
+Game::~Game() {
+}
 
-    // Center the player in the screen
+void Game::spawnPlayer(int slot) {
     auto player = entityManager.addEntity("player");
-    float centerX = window.getSize().x / 2.0f;
-    float centerY = window.getSize().y / 2.0f;
-    player->add<CTransform>(Vec2<float>(centerX, centerY), Vec2<float>(0.0f, 0.0f)); // Centered position
-    player->add<CInput>();
+    player->add<CTransform>(playerSpawnPoint(slot), Vec2<float>(0.0f, 0.0f));
+    player->add<CInput>(slot);
 
     // Set random player color
-    sf::Color PlayerColor = getRandomBrightColor();
+    sf::Color PlayerColor = getRandomBrightColor(colorRandom);
 
     // Set random player number of sides
-    int playerShapeSides = getRandom<int>(3, 8);
+    int playerShapeSides = getRandom<int>(spawnRandom, 3, 8);
 
     // Add Components to player
     player->add<CShape>(playerShapeSides, playerRadius, PlayerColor);
     player->add<CRotation>(0.0f, playerRotationSpeed);
-    player->add<CCollision>(playerRadius, true, false);
+    player->add<CCollision>(playerRadius, CollisionLayer::Player, true, true); // Trigger: hits hurt, nothing is pushed
+    player->add<CPolygon>(playerShapeSides, playerRadius); // Hits match the drawn outline
     player->add<CLives>(playerLives);
     player->add<CState>();
+    player->add<CWeapon>(playerShapeSides * supermoveCooldownPerSide); // Supermove cooldown grows with the number of sides
+}
 
+Vec2<float> Game::playerSpawnPoint(int slot) const {
+    // Players stand side by side around the center of the screen
+    int players = session ? session->playerCount() : 1;
+    float offset = (slot - (players - 1) / 2.0f) * playerRadius * 3.0f;
+    return Vec2<float>(worldWidth / 2.0f + offset, worldHeight / 2.0f);
+}
 
-    // Initialize supermove timer based on player shape sides
-    supermoveCooldown = playerShapeSides; // Cooldown duration is equal to the number of sides
-    supermoveTimer = 0.0f;     // Timer starts at 0
+std::shared_ptr<Entity> Game::localPlayer() {
+    return playerInSlot(session ? session->localSlot() : 0);
 }
 
-Game::~Game() {
+std::shared_ptr<Entity> Game::playerInSlot(int slot) {
+    for (auto& player : entityManager.getEntities("player")) {
+        if (player->get<CInput>().slot == slot) {
+            return player;
+        }
+    }
+    return nullptr;
 }
 
 void Game::run() {
-    sf::Clock deltaClock; // SFML clock for delta time
+    auto stepStart = InputSampler::Clock::now(); // Start of the span the next update covers
+    auto frameDeadline = stepStart;              // When the current frame may end (60 frames per second)
+    bool firstFrame = true;
 
-    while (window.isOpen()) {
-        // Handle input
-        handleInput();
+    auto micros = [](InputSampler::Clock::duration duration) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    };
 
+    while (running) {
         // Calculate delta time
-        sf::Time deltaTime = deltaClock.restart();
-        float dt = deltaTime.asSeconds();
+        auto stepEnd = InputSampler::Clock::now();
+        float dt = std::chrono::duration<float>(stepEnd - stepStart).count();
+        if (!firstFrame) {
+            frameStats.frame.record(micros(stepEnd - stepStart));
+        }
 
-        // Update game logic
-        update(dt);
+        // Handle input sampled during this step
+        if (window) {
+            handleInput(stepStart, stepEnd);
+        }
+        stepStart = stepEnd;
+
+        // Update game logic (fixed lockstep ticks in a network session)
+        auto simulationStart = InputSampler::Clock::now();
+        if (session) {
+            updateNetwork(dt);
+        } else if (bot) {
+            updateBot();
+        } else {
+            update(dt);
+        }
+        auto renderStart = InputSampler::Clock::now();
+        frameStats.simulation.record(micros(renderStart - simulationStart));
 
         // Render the game
-        render();
+        if (window) {
+            render();
+        }
+        auto presented = InputSampler::Clock::now();
+        frameStats.render.record(micros(presented - renderStart));
+        if (window) {
+            quality.record(std::chrono::duration<double, std::milli>(presentStart - simulationStart).count());
+        }
+        if (inputPending) {
+            frameStats.inputToPresent.record(micros(presented - oldestInputTime));
+            inputPending = false;
+        }
+
+        // The frame limit: sample input until the next frame is due (headless runs never wait)
+        if (window) {
+            frameDeadline = std::max(frameDeadline + frameInterval, presented);
+            inputSampler.sampleUntil(*window, frameDeadline);
+        }
+
+        // Soak run controls (see FrameStats.hpp)
+        if (latencyReportRequested) {
+            latencyReportRequested = 0;
+            writeLatencyReport();
+        }
+        if (shutdownRequested) {
+            stop();
+        }
+
+        if (firstFrame) {
+            firstFrame = false;
+            startupTimeline.mark("first frame");
+            if (options.startupProfile) {
+                startupTimeline.print(std::cout);
+            }
+        }
+    }
+
+    if (session) {
+        session->printStats(std::cout);
+    }
+    finishLatencyReport();
+}
+
+void Game::stop() {
+    running = false;
+    if (window) {
+        window->close();
+    }
+}
+
+void Game::writeLatencyReport() {
+    if (!options.latencyReport.empty()) {
+        frameStats.writeFile(options.latencyReport);
+    } else {
+        frameStats.print(std::cout);
     }
 }
 
+void Game::finishLatencyReport() {
+    if (options.latencyReport.empty() && options.latencyBudget.empty()) {
+        return;
+    }
+    writeLatencyReport();
+
+    if (!options.latencyBudget.empty() &&
+        !checkLatencyBudgets(frameStats, parseLatencyBudgets(options.latencyBudget), std::cerr)) {
+        m_exitCode = 1;
+    }
+}
+
+// Bot Runs
+
+void Game::updateBot() {
+    // Accelerated time: several fixed steps per frame (as fast as possible when headless)
+    for (int step = 0; step < options.timeScale; ++step) {
+        if (gameState == GameState::GameOver) {
+            restartGame();
+        }
+        if (auto player = localPlayer()) {
+            bot->control(*player, entityManager.getEntities("enemy"),
+                         worldWidth, worldHeight,
+                         1.0f / bulletSpeed, timers.now(), botStepDt); // Bullets reach their aim point in 1 / bulletSpeed seconds
+        }
+
+        auto stepStart = InputSampler::Clock::now();
+        update(botStepDt);
+        double stepMs = std::chrono::duration<double, std::milli>(InputSampler::Clock::now() - stepStart).count();
+
+        if (soakRecorder.isOpen()) {
+            SoakSample sample;
+            sample.players = entityManager.countEntities("player");
+            sample.enemies = entityManager.countEntities("enemy");
+            sample.bullets = entityManager.countEntities("bullet") + bulletPatterns.liveBullets();
+            sample.entities = entityManager.getEntities().size();
+            sample.particles = particles.size();
+            for (auto& enemy : entityManager.getEntities("enemy")) {
+                sample.maxEnemySpeed = std::max(sample.maxEnemySpeed, enemy->get<CTransform>().velocity.magnitude());
+            }
+            for (auto& bullet : entityManager.getEntities("bullet")) {
+                sample.maxBulletSpeed = std::max(sample.maxBulletSpeed, bullet->get<CTransform>().velocity.magnitude());
+            }
+            sample.stepMs = stepMs;
+            sample.collisions = collisionCounters;
+            sample.bulletsExpired = expiredBullets;
+            sample.crowdedSpawns = spawnPlacer.takeCrowded();
+            soakRecorder.record(sample, botStepDt);
+        }
+
+        botTime += botStepDt;
+        if (options.botDuration > 0.0f && botTime >= options.botDuration) {
+            stop();
+            break;
+        }
+    }
+}
+
+void Game::restartGame() {
+    // Clear the world (pending entities are added first so they are destroyed too)
+    entityManager.update();
+    for (auto& entity : entityManager.getEntities()) {
+        entity->destroy();
+    }
+    entityManager.update();
+    particles.clear();
+    bulletPatterns.clear();
+    events.clear();
+
+    totalPoints = 0;
+    survivalTimer = 0.0f;
+    gameState = GameState::Playing;
+    spawnPlayer(0);
+    startWaveScripts();
+    soakRecorder.noteRestart();
+}
+
+// Training Episodes
+
+void Game::resetEpisode(uint64_t seed, uint32_t substream) {
+    seedRandom(seed, substream);
+    restartGame();
+    entityManager.update(); // Make the new player visible to observe()
+    stepPoints = 0;
+}
+
+void Game::stepEpisode(const PlayerInput& action, float dt) {
+    if (auto player = localPlayer()) {
+        applyInput(player->get<CInput>(), action);
+    }
+    int pointsBefore = totalPoints;
+    update(dt);
+    stepPoints = totalPoints - pointsBefore;
+}
+
+void Game::observe(float* out) {
+    // Layout documented in GameEnv.h; missing enemies and a missing player stay zero
+    std::fill(out, out + GAME_ENV_OBSERVATION_SIZE, 0.0f);
+    auto& enemies = entityManager.getEntities("enemy");
+    out[6] = static_cast<float>(stepPoints) / 100.0f;
+    out[7] = static_cast<float>(enemies.size()) / 100.0f;
+
+    auto player = localPlayer();
+    if (!player) {
+        return;
+    }
+    const auto& position = player->get<CTransform>().position;
+    const auto& weapon = player->get<CWeapon>();
+    double now = timers.now();
+    out[0] = position.x / worldWidth;
+    out[1] = position.y / worldHeight;
+    out[2] = static_cast<float>(player->get<CLives>().remaining) / static_cast<float>(playerLives);
+    out[3] = weapon.shotReadyTime <= now ? 1.0f : 0.0f;
+    out[4] = weapon.supermoveReadyTime <= now ? 1.0f : 0.0f;
+    out[5] = player->get<CState>().isInvincible ? 1.0f : 0.0f;
+
+    // Nearest enemies first
+    nearestEnemies.clear();
+    for (auto& enemy : enemies) {
+        nearestEnemies.emplace_back(enemy->get<CTransform>().position.distanceSquared(position), enemy.get());
+    }
+    size_t count = std::min<size_t>(nearestEnemies.size(), GAME_ENV_NEAREST_ENEMIES);
+    std::partial_sort(nearestEnemies.begin(), nearestEnemies.begin() + count, nearestEnemies.end(),
+                      [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    float* features = out + 8;
+    for (size_t i = 0; i < count; ++i, features += GAME_ENV_ENEMY_FEATURES) {
+        const auto& transform = nearestEnemies[i].second->get<CTransform>();
+        const auto& shape = nearestEnemies[i].second->get<CShape>();
+        features[0] = 1.0f; // Present
+        features[1] = (transform.position.x - position.x) / worldWidth;
+        features[2] = (transform.position.y - position.y) / worldHeight;
+        features[3] = transform.velocity.x / enemySpeed;
+        features[4] = transform.velocity.y / enemySpeed;
+        features[5] = shape.radius / playerRadius;
+        features[6] = static_cast<float>(shape.sides) / 8.0f;
+    }
+}
+
+// Balance Sweeps
+
+const std::vector<std::pair<std::string, Game::TunableMember>>& Game::tunables() {
+    static const std::vector<std::pair<std::string, TunableMember>> table = {
+        {"playerSpeed", &Game::playerSpeed},
+        {"playerLives", &Game::playerLives},
+        {"playerInvincibilityTime", &Game::playerInvincibilityTime},
+        {"supermoveCooldownPerSide", &Game::supermoveCooldownPerSide},
+        {"enemySpawnInterval", &Game::enemySpawnInterval},
+        {"enemySpeed", &Game::enemySpeed},
+        {"enemyRadius", &Game::enemyRadius},
+        {"maxEnemyPerFrame", &Game::maxEnemyPerFrame},
+        {"spawnProtectionTime", &Game::spawnProtectionTime},
+        {"ringWaveInterval", &Game::ringWaveInterval},
+        {"ringWaveSize", &Game::ringWaveSize},
+        {"ringWaveRadius", &Game::ringWaveRadius},
+        {"enemySpawnSpacing", &Game::enemySpawnSpacing},
+        {"spawnPlayerClearance", &Game::spawnPlayerClearance},
+        {"superBulletSpeed", &Game::superBulletSpeed},
+        {"bulletSpeed", &Game::bulletSpeed},
+        {"bulletCooldown", &Game::bulletCooldown},
+        {"bulletLifeTime", &Game::bulletLifeTime},
+        {"fragmentSpeed", &Game::fragmentSpeed},
+        {"fragmentLifeTime", &Game::fragmentLifeTime},
+    };
+    return table;
+}
+
+bool Game::setTunable(const std::string& name, double value) {
+    for (const auto& [knob, member] : tunables()) {
+        if (knob != name) {
+            continue;
+        }
+        // Integer knobs round to the nearest value (counts never go below zero)
+        std::visit([&](auto pointer) {
+            using Value = std::remove_reference_t<decltype(this->*pointer)>;
+            if constexpr (std::is_same_v<Value, float>) {
+                this->*pointer = static_cast<float>(value);
+            } else {
+                this->*pointer = static_cast<Value>(std::llround(std::max(value, 0.0)));
+            }
+        }, member);
+        return true;
+    }
+    return false;
+}
+
+std::vector<std::string> Game::tunableNames() {
+    std::vector<std::string> names;
+    for (const auto& entry : tunables()) {
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+void Game::stepBotEpisode(BotController& driver, float dt) {
+    if (auto player = localPlayer()) {
+        driver.control(*player, entityManager.getEntities("enemy"), worldWidth, worldHeight,
+                       1.0f / bulletSpeed, timers.now(), dt);
+    }
+    int pointsBefore = totalPoints;
+    update(dt);
+    stepPoints = totalPoints - pointsBefore;
+}
+
+// Network Session
+
+void Game::updateNetwork(float dt) {
+    session->service();
+    if (!session->started()) {
+        return; // Still waiting for every player to join
+    }
+
+    // Every peer seeds from the session and spawns players in slot order, so
+    // the random sequence matches from the first tick
+    if (!networkPlayersSpawned) {
+        seedRandom(session->seed());
+        for (int slot = 0; slot < session->playerCount(); ++slot) {
+            spawnPlayer(slot);
+        }
+        networkPlayersSpawned = true;
+    }
+
+    // Simulate in fixed ticks; the accumulator is clamped so a long stall does
+    // not turn into a burst of catch-up ticks
+    networkAccumulator = std::min(networkAccumulator + dt, maxNetworkCatchUp);
+    while (networkAccumulator >= networkTickDt) {
+        uint32_t inputTick = networkTick + LockstepSession::inputDelay;
+        if (!session->hasLocalInput(inputTick)) {
+            session->submitLocalInput(inputTick, scriptedInput ? scriptedInput(inputTick) : sampleLocalInput());
+        }
+        if (!session->readyToStep(networkTick)) {
+            session->noteStall();
+            break;
+        }
+
+        // Snap to the keyframe taken after the previous tick
+        if (networkTick > 0 && (networkTick - 1) % LockstepSession::keyframeInterval == 0) {
+            applyKeyframe(networkTick - 1);
+        }
+
+        const auto& inputs = session->inputs(networkTick);
+        for (auto& player : entityManager.getEntities("player")) {
+            auto& input = player->get<CInput>();
+            applyInput(input, inputs[input.slot]);
+        }
+
+        update(networkTickDt);
+        if (options.simulationOnly) {
+            tickChecksums.push_back(stateChecksum()); // Before the host snaps to its keyframe
+        }
+
+        if (session->isHost() && networkTick % LockstepSession::keyframeInterval == 0) {
+            session->sendKeyframe(networkTick, captureKeyframe());
+        }
+        session->endTick(networkTick);
+        ++networkTick;
+        networkAccumulator -= networkTickDt;
+    }
+}
+
+void Game::joinSession(std::unique_ptr<LockstepSession> peer) {
+    // Start from an empty world, as a windowed peer does: updateNetwork
+    // spawns every player once the session starts
+    entityManager.update();
+    for (auto& entity : entityManager.getEntities()) {
+        entity->destroy();
+    }
+    entityManager.update();
+    session = std::move(peer);
+    entityManager.setSpatialSort(GameOptions().spatialSortInterval, collisionCellSize);
+}
+
+uint64_t Game::stateChecksum() {
+    // FNV-1a over the exact bits of everything the simulation carries between
+    // ticks, in id order (storage order is spatial and may differ by history)
+    uint64_t hash = 0xCBF29CE484222325ull;
+    auto mix = [&hash](uint64_t value) {
+        for (int byte = 0; byte < 8; ++byte) {
+            hash = (hash ^ ((value >> (byte * 8)) & 0xFF)) * 0x100000001B3ull;
+        }
+    };
+    auto bits = [](float value) { return static_cast<uint64_t>(std::bit_cast<uint32_t>(value)); };
+
+    std::vector<const Entity*> sorted;
+    for (auto& entity : entityManager.getEntities()) {
+        sorted.push_back(entity.get());
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Entity* a, const Entity* b) { return a->id() < b->id(); });
+    for (const Entity* entity : sorted) {
+        const auto& transform = entity->get<CTransform>();
+        mix(entity->id());
+        for (char c : entity->tag()) {
+            mix(static_cast<uint8_t>(c));
+        }
+        mix(bits(transform.position.x) | bits(transform.position.y) << 32);
+        mix(bits(transform.velocity.x) | bits(transform.velocity.y) << 32);
+        mix(static_cast<uint64_t>(entity->get<CLives>().remaining));
+    }
+    mix(static_cast<uint64_t>(totalPoints));
+    mix(spawnRandom.position());
+    mix(colorRandom.position());
+    return hash;
+}
+
+std::vector<EntitySnapshot> Game::captureKeyframe() {
+    std::vector<EntitySnapshot> world;
+    for (auto& entity : entityManager.getEntities()) {
+        auto& transform = entity->get<CTransform>();
+        EntitySnapshot snapshot{
+            static_cast<uint32_t>(entity->id()),
+            quantize(transform.position.x), quantize(transform.position.y),
+            quantize(transform.velocity.x), quantize(transform.velocity.y)
+        };
+
+        // The host snaps its own state too, so every peer continues from identical values
+        transform.position = Vec2<float>(dequantize(snapshot.x), dequantize(snapshot.y));
+        transform.velocity = Vec2<float>(dequantize(snapshot.vx), dequantize(snapshot.vy));
+        world.push_back(snapshot);
+    }
+    // Storage is in spatial order; keyframes are delta coded by ascending id
+    std::sort(world.begin(), world.end(), [](const auto& a, const auto& b) { return a.id < b.id; });
+    return world;
+}
+
+void Game::applyKeyframe(uint32_t tick) {
+    if (session->isHost()) {
+        return; // The host snapped itself in captureKeyframe
+    }
+
+    // Without the keyframe, snap locally: quantizing is deterministic, so an
+    // in-sync client still lands on exactly the host's values
+    std::vector<EntitySnapshot> world;
+    bool received = session->takeKeyframe(tick, world);
+    std::unordered_map<uint32_t, const EntitySnapshot*> byId;
+    for (const auto& snapshot : world) {
+        byId[snapshot.id] = &snapshot;
+    }
+
+    uint32_t corrections = 0;
+    for (auto& entity : entityManager.getEntities()) {
+        auto& transform = entity->get<CTransform>();
+        EntitySnapshot local{
+            static_cast<uint32_t>(entity->id()),
+            quantize(transform.position.x), quantize(transform.position.y),
+            quantize(transform.velocity.x), quantize(transform.velocity.y)
+        };
+
+        auto found = byId.find(local.id);
+        if (received && found != byId.end()) {
+            const EntitySnapshot& remote = *found->second;
+            if (remote.x != local.x || remote.y != local.y || remote.vx != local.vx || remote.vy != local.vy) {
+                ++corrections;
+                local = remote;
+            }
+        } else if (received) {
+            ++corrections; // Entity the host does not have
+        }
+
+        transform.position = Vec2<float>(dequantize(local.x), dequantize(local.y));
+        transform.velocity = Vec2<float>(dequantize(local.vx), dequantize(local.vy));
+    }
+    session->noteCorrections(corrections);
+}
+
 // Input Handling
 
-void Game::handleInput() {
+void Game::handleInput(InputSampler::Clock::time_point stepStart, InputSampler::Clock::time_point stepEnd) {
     sf::Event event;
-    while (window.pollEvent(event)) {
+    while (window->pollEvent(event)) {
         // Close the window if the close event is triggered
         if (event.type == sf::Event::Closed) {
-            window.close();
+            stop();
         }
 
-        // Handle mouse button inputs
-        if (event.type == sf::Event::MouseButtonPressed) {
-            if (event.mouseButton.button == sf::Mouse::Left) {
-                fireBullet(); // Fire a normal bullet
-            }
+        // The sampler ignores keyboard and mouse while the window is not focused
+        if (event.type == sf::Event::GainedFocus) {
+            inputSampler.setFocused(true);
+        }
+        if (event.type == sf::Event::LostFocus) {
+            inputSampler.setFocused(false);
         }
+    }
 
-        // Handle keypress inputs
-        if (event.type == sf::Event::KeyPressed) {
-            if (event.key.code == sf::Keyboard::Space && supermoveReady) {
-                activateSupermove(); // Trigger supermove
+    // Fire is checked against the cooldown at the moment of the click (single player only;
+    // lockstep ticks apply actions at tick boundaries)
+    auto player = session ? nullptr : localPlayer();
+    float dt = std::chrono::duration<float>(stepEnd - stepStart).count();
+
+    // Replay this step's input events in order, timing each as a fraction of the step
+    Vec2<float> moveTime(0.0f, 0.0f); // Movement direction integrated over the step
+    float segmentStart = 0.0f;
+    InputEvent input;
+    while (inputSampler.poll(input, stepEnd)) {
+        if (!inputPending) {
+            oldestInputTime = input.time; // Presented at the end of this frame
+            inputPending = true;
+        }
+        float t = dt > 0.0f ? std::clamp(std::chrono::duration<float>(input.time - stepStart).count() / dt, 0.0f, 1.0f) : 0.0f;
+
+        switch (input.type) {
+        case InputEvent::Move:
+            moveTime += moveDirection(heldMoveKeys) * (t - segmentStart);
+            segmentStart = t;
+            heldMoveKeys = input.moveKeys;
+            break;
+        case InputEvent::Fire:
+            if (!fireRequested && (!player || player->get<CWeapon>().shotReadyTime <= timers.now() + t * dt)) {
+                fireRequested = true; // Fire a normal bullet on the next update
+                fireTime = t;
+                fireAim = windowToWorld(input.mouseX, input.mouseY);
             }
+            break;
+        case InputEvent::Supermove:
+            if (!supermoveRequested) {
+                supermoveRequested = true; // Trigger supermove on the next update
+                supermoveTime = t;
+            }
+            break;
         }
     }
+    moveTime += moveDirection(heldMoveKeys) * (1.0f - segmentStart);
 
-    // Update the player's input component for movement (WASD keys)
-    for (auto& entity : entityManager.getEntities("player")) {
-        auto& input = entity->get<CInput>();
+    // In a network session the input is sampled once per tick by updateNetwork
+    if (!player) {
+        return;
+    }
 
-        // Record input states
-        input.up = sf::Keyboard::isKeyPressed(sf::Keyboard::W);
-        input.down = sf::Keyboard::isKeyPressed(sf::Keyboard::S);
-        input.left = sf::Keyboard::isKeyPressed(sf::Keyboard::A);
-        input.right = sf::Keyboard::isKeyPressed(sf::Keyboard::D);
+    // Update the player's input component
+    auto& playerInput = player->get<CInput>();
+    float clickTime = fireTime;
+    float pressTime = supermoveTime;
+    applyInput(playerInput, sampleLocalInput());
+    playerInput.move = moveTime;
+    playerInput.fireTime = clickTime;
+    playerInput.supermoveTime = pressTime;
+}
+
+Vec2<float> Game::moveDirection(uint8_t moveKeys) {
+    Vec2<float> direction(0.0f, 0.0f);
+    if (moveKeys & MoveUp) direction.y -= 1.0f;
+    if (moveKeys & MoveDown) direction.y += 1.0f;
+    if (moveKeys & MoveLeft) direction.x -= 1.0f;
+    if (moveKeys & MoveRight) direction.x += 1.0f;
+    return direction;
+}
+
+Vec2<float> Game::windowToWorld(int x, int y) {
+    sf::Vector2f world = window->mapPixelToCoords(sf::Vector2i(x, y));
+    return Vec2<float>(world.x, world.y);
+}
+
+PlayerInput Game::sampleLocalInput() {
+    PlayerInput input;
+
+    // Record movement states (WASD keys, as last reported by the sampler)
+    input.up = heldMoveKeys & MoveUp;
+    input.down = heldMoveKeys & MoveDown;
+    input.left = heldMoveKeys & MoveLeft;
+    input.right = heldMoveKeys & MoveRight;
+
+    // Actions requested since the last sample
+    input.fire = fireRequested;
+    input.supermove = supermoveRequested;
+    fireRequested = false;
+    supermoveRequested = false;
+
+    // Aim where the click happened, or at the current mouse position (if there is a window)
+    Vec2<float> aim = fireAim;
+    if (!input.fire && window) {
+        sf::Vector2f worldMousePosition = window->mapPixelToCoords(sf::Mouse::getPosition(*window));
+        aim = Vec2<float>(worldMousePosition.x, worldMousePosition.y);
     }
+    input.aimX = static_cast<int32_t>(aim.x);
+    input.aimY = static_cast<int32_t>(aim.y);
+    return input;
 }
 
-void Game::fireBullet(bool isSupermove) {
-    // Check if the bullet is on cooldown (only for normal bullets)
-    if (!isSupermove && bulletCooldownTimer > 0.0f) {
-        return;
+void Game::applyInput(CInput& input, const PlayerInput& sample) {
+    input.up = sample.up;
+    input.down = sample.down;
+    input.left = sample.left;
+    input.right = sample.right;
+    input.fire = sample.fire;
+    input.supermove = sample.supermove;
+    input.aim = Vec2<float>(static_cast<float>(sample.aimX), static_cast<float>(sample.aimY));
+    input.move = Vec2<float>(static_cast<float>(sample.right - sample.left), static_cast<float>(sample.down - sample.up));
+    input.fireTime = 0.0f;
+    input.supermoveTime = 0.0f;
+}
+
+void Game::updatePlayerActions(float dt) {
+    for (auto& player : entityManager.getEntities("player")) {
+        auto& input = player->get<CInput>();
+        if (input.fire) {
+            fireBullet(player, dt);
+        }
+        if (input.supermove) {
+            activateSupermove(player, dt);
+        }
+        input.fire = false;
+        input.supermove = false;
     }
+}
 
-    // Get the player's position
-    auto& player = entityManager.getEntities("player").front();
-    auto& playerTransform = player->get<CTransform>();
+Vec2<float> Game::playerPositionAt(const std::shared_ptr<Entity>& player, float elapsed) {
+    const auto& transform = player->get<CTransform>();
+    const auto& shape = player->get<CShape>();
+    Vec2<float> position = transform.position + player->get<CInput>().move * (playerSpeed * elapsed);
+    position.x = std::clamp(position.x, shape.radius, worldWidth - shape.radius);
+    position.y = std::clamp(position.y, shape.radius, worldHeight - shape.radius);
+    return position;
+}
 
-    // Calculate the direction toward the mouse position
-    sf::Vector2i mousePosition = sf::Mouse::getPosition(window);
-    sf::Vector2f worldMousePosition = window.mapPixelToCoords(mousePosition);
+void Game::fireBullet(const std::shared_ptr<Entity>& player, float dt, bool isSupermove) {
+    auto& weapon = player->get<CWeapon>();
+    float elapsed = player->get<CInput>().fireTime * dt; // Time into this update when fire was pressed
 
-    Vec2<float> direction(
-        worldMousePosition.x - playerTransform.position.x,
-        worldMousePosition.y - playerTransform.position.y
-    );
+    // Check if the bullet is on cooldown at the moment of the click (only for normal bullets)
+    if (!isSupermove && weapon.shotReadyTime > timers.now() + elapsed) {
+        return;
+    }
 
-    // Create a bullet entity
-    auto bullet = entityManager.addEntity("bullet");
-    bullet->add<CTransform>(
-        playerTransform.position, // Spawn bullet at player's position
-        direction * bulletSpeed         // Apply the fixed speed multiplier
-    );
+    // Get the player's position at the moment of the click
+    Vec2<float> spawnPosition = playerPositionAt(player, elapsed);
 
-    bullet->add<CShape>(
-        20,                          // Use high number of sides to approximate circular shape
-        playerRadius / 6.0f,         // Use smaller radius for bullets
-        sf::Color::White // Color based on type (super or not)
+    // Calculate the direction toward the player's aim point
+    const auto& aim = player->get<CInput>().aim;
+    Vec2<float> direction(
+        aim.x - spawnPosition.x,
+        aim.y - spawnPosition.y
     );
-    bullet->add<CLifeSpan>(bulletLifeTime);  // Bullets live for bulletLifeTime second
+    Vec2<float> velocity = direction * bulletSpeed; // Apply the fixed speed multiplier
+
+    // Create a bullet entity, backdated so that after this update's full step
+    // it is where a bullet fired at the click would be (recorded: this runs inside the player loop)
+    Vec2<float> position = spawnPosition - velocity * elapsed;
+    float radius = playerRadius / 6.0f, lifeTime = bulletLifeTime;
+    commands[0].createEntity("bullet", [this, position, velocity, radius, lifeTime, elapsed](const std::shared_ptr<Entity>& bullet) {
+        bullet->add<CTransform>(position, velocity);
+        bullet->add<CShape>(
+            20,                          // Use high number of sides to approximate circular shape
+            radius,                      // Use smaller radius for bullets
+            sf::Color::White // Color based on type (super or not)
+        );
+        bullet->add<CCollision>(radius, CollisionLayer::Bullet, true, true);
+        bullet->add<CLifeSpan>(lifeTime);  // Bullets live for bulletLifeTime second from the click
+        timers.schedule(elapsed + lifeTime, TimerExpired{TimerExpired::BulletLifespan, bullet});
+    });
 
-    // Reset bullet cooldown timer for normal bullets
+    // Reset bullet cooldown timer for normal bullets (counting from the click)
     if (!isSupermove) {
-        bulletCooldownTimer = bulletCooldown;
+        weapon.shotReadyTime = timers.now() + elapsed + bulletCooldown;
+        player->markChanged<CWeapon>();
     }
 }
 
-void Game::activateSupermove() {
-    if (!supermoveReady) {
+void Game::activateSupermove(const std::shared_ptr<Entity>& player, float dt) {
+    auto& weapon = player->get<CWeapon>();
+    float elapsed = player->get<CInput>().supermoveTime * dt;
+    if (timers.now() + elapsed < weapon.supermoveReadyTime) {
         return;
     }
 
-    // Get the player's position and shape
-    auto& player = entityManager.getEntities("player").front();
-    auto& playerTransform = player->get<CTransform>();
+    // Get the player's position at the key press and shape
+    Vec2<float> spawnPosition = playerPositionAt(player, elapsed);
     auto& playerShape = player->get<CShape>();
 
-    // Fire bullets in directions based on the number of sides of the player's shape
-    float angleIncrement = 360.0f / playerShape.sides; // Divide 360° by the number of sides
-    for (int i = 0; i < playerShape.sides; ++i) {
-        float angle = angleIncrement * i;
-
-        // Calculate direction vector for this bullet
-        float radian = angle * (3.14159265f / 180.0f); // Convert to radians
-        Vec2<float> direction(std::cos(radian), std::sin(radian));
-        direction.normalize(); // Ensure consistent speed
-
-        // Create a bullet entity
-        auto bullet = entityManager.addEntity("bullet");
-        bullet->add<CTransform>(
-            playerTransform.position, // Spawn bullet at player's position
-            direction * 500.0f        // Fixed bullet speed for supermove
-        );
-        bullet->add<CShape>(
-            20,                          
-            playerRadius / 2.0f,         
-            sf::Color::Red               // Red color for supermove bullets
-        );
-        bullet->add<CLifeSpan>(bulletLifeTime * 1.5); //Make the super bullets last longer than normal bullets
-    }
+    // One ring pattern with a bullet per side of the player's shape, evaluated
+    // analytically from the key press (backdated like fireBullet)
+    BulletPattern ring = BulletPattern::ring(spawnPosition, bulletPatterns.time() + elapsed,
+                                             static_cast<uint32_t>(playerShape.sides), superBulletSpeed);
+    ring.radius = playerRadius / 2.0f;
+    ring.color = sf::Color::Red;        // Red color for supermove bullets
+    ring.lifetime = bulletLifeTime * 1.5f; // Make the super bullets last longer than normal bullets
+    bulletPatterns.emit(ring);
 
     // Set supermove on cooldown
-    supermoveReady = false;
-    supermoveTimer = supermoveCooldown;
+    weapon.supermoveReadyTime = timers.now() + elapsed + weapon.supermoveCooldown;
+    player->markChanged<CWeapon>();
 }
 
 void Game::update(float dt) {
@@ -196,27 +844,31 @@ void Game::update(float dt) {
         return;
     }
 
+    updatePlayerActions(dt);
+    commands.flush(entityManager); // Sync point: bullets fired since the last update join this one
     updateSurvivalPoints(dt);
-    updateBulletCooldown(dt);
-    updatePlayerInvincibility(dt);
-    updateSupermoveCooldown(dt);
 
     entityManager.update(); // Update ECS
-    spawnEnemies(dt);       // Spawn enemies
+    scripts.update(dt);     // Wave scripts (spawning)
     updateBullets(dt);      // Update bullets
+    bulletPatterns.update(dt); // Pattern bullets only advance their clock
     updateFragments(dt);    // Update fragments
-
-    // Update enemy spawn times
-    for (auto& enemy : entityManager.getEntities("enemy")) {
-        auto& spawnTime = enemy->get<CSpawnTime>();
-        spawnTime.timeSinceSpawn += dt;
-    }
+    updateTimers(dt);       // Lifespans, invincibility and spawn protection
+    commands.flush(entityManager); // Sync point: apply lifespan expiries before collisions
 
     updatePlayer(dt);
     processEnemyMovement(dt);
 
     updateCollisions();  // Handle collisions
-    updateHUD();         // Update HUD
+    collidePatternBullets(dt);
+    processEvents();     // Scoring, explosions and player damage, one batch each
+    commands.flush(entityManager); // Sync point: apply kills and spawned fragments
+    telemetry.update(dt, entityManager.getEntities(), static_cast<uint8_t>(quality.level())); // Copies a sample every telemetryInterval updates
+    hudTimer += dt;
+    if (window && hudTimer >= quality.settings().hudInterval) {
+        hudTimer = 0.0f;
+        updateHUD();     // Update HUD (less often when the governor sheds load)
+    }
 }
 
 void Game::updateSurvivalPoints(float dt) {
@@ -227,250 +879,261 @@ void Game::updateSurvivalPoints(float dt) {
     }
 }
 
-void Game::updatePlayerInvincibility(float dt) {
-    for (auto& player : entityManager.getEntities("player")) {
-        auto& state = player->get<CState>();
-
-        if (state.isInvincible) {
-            state.invincibilityTimer -= dt; // Decrease the timer
-            if (state.invincibilityTimer <= 0.0f) {
-                state.isInvincible = false; // End invincibility
-                state.invincibilityTimer = 0.0f; // Ensure timer is reset
-            }
-        }
-    }
+void Game::updateTimers(float dt) {
+    // Only timers that run out are touched, however many entities are alive
+    timers.advance(dt, [this](const TimerExpired& timer) { handleTimer(timer); });
 }
 
-void Game::updateBulletCooldown(float dt) {
-    if (bulletCooldownTimer > 0.0f) {
-        bulletCooldownTimer -= dt; // Decrease cooldown
-        if (bulletCooldownTimer < 0.0f) {
-            bulletCooldownTimer = 0.0f; // Clamp to zero
-        }
+void Game::handleTimer(const TimerExpired& timer) {
+    auto entity = timer.entity.lock();
+    if (!entity || !entity->isAlive()) {
+        return; // Destroyed before its timer ran out
     }
-}
 
-void Game::updateSupermoveCooldown(float dt) {
-    if (!supermoveReady) {
-        supermoveTimer -= dt;
-        if (supermoveTimer <= 0.0f) {
-            supermoveReady = true; // Supermove is ready again
-            supermoveTimer = 0.0f; // Reset timer
-        }
+    switch (timer.kind) {
+    case TimerExpired::BulletLifespan:
+        events.emit(BulletExpired{entity->id(), entity->get<CTransform>().position});
+        commands[0].destroyEntity(entity);
+        break;
+    case TimerExpired::Invincibility:
+        // Hits are ignored while invincible, so a player has at most one pending
+        entity->modify<CState>().isInvincible = false;
+        break;
+    case TimerExpired::SpawnProtection:
+        entity->modify<CSpawnTime>().isProtected = false;
+        break;
     }
 }
 
 void Game::updateBullets(float dt) {
     for (auto& bullet : entityManager.getEntities("bullet")) {
         auto& transform = bullet->get<CTransform>();
-        auto& lifespan = bullet->get<CLifeSpan>();
 
-        // Update bullet position
+        // Update bullet position, keeping the start of the step for swept collision
+        transform.prevPosition = transform.position;
         transform.position += transform.velocity * dt;
+    }
+}
+
+void Game::updateFragments(float dt) {
+    // Fragments are particles: integrate positions and retire expired ones
+    particles.update(dt);
+}
+
+void Game::updateCollisions() {
+    collisionCounters = CollisionCounters{};
+
+    // Broad phase per layer; only the pairs enabled in the collision matrix are tested
+    collisionWorld.build(entityManager.getEntities(), worldWidth, worldHeight, collisionCellSize);
+    enemyClaimed.assign(collisionWorld.colliders(CollisionLayer::Enemy).size(), 0);
 
-        // Reduce lifespan
-        lifespan.remainingTime -= dt;
+    // Under load the enemy-enemy solver runs every few steps (it only pushes enemies
+    // apart); lockstep sessions always run it so every machine simulates the same
+    ++collisionSteps;
+    bool solveEnemies = session || collisionSteps % quality.settings().enemySolverInterval == 0;
 
-        // Destroy bullet if its lifespan is over
-        if (lifespan.remainingTime <= 0.0f) {
-            bullet->destroy();
+    for (const auto& [query, target] : collisionWorld.matrix.pairs()) {
+        if (query == CollisionLayer::Enemy && target == CollisionLayer::Enemy && !solveEnemies) {
+            continue;
+        }
+        size_t tests = collisionWorld.resolve(query, target, [&](size_t i, size_t j, float) {
+            return handleContact(query, target, i, j);
+        });
+
+        if (query == CollisionLayer::Player) {
+            collisionCounters.playerEnemyTests += tests;
+        } else if (query == CollisionLayer::Enemy) {
+            collisionCounters.enemyPairTests += tests;
+        } else if (query == CollisionLayer::Bullet) {
+            collisionCounters.bulletTests += tests;
         }
     }
 }
 
-void Game::updateFragments(float dt) {
-    for (auto& fragment : entityManager.getEntities("fragment")) {
-        auto& transform = fragment->get<CTransform>();
-        auto& shape = fragment->get<CShape>();
-        auto& lifespan = fragment->get<CLifeSpan>();
-        auto& rotation = fragment->get<CRotation>();
+void Game::collidePatternBullets(float dt) {
+    if (!collisionWorld.matrix.interacts(CollisionLayer::Bullet, CollisionLayer::Enemy)) {
+        return;
+    }
 
-        // Update position using velocity
-        transform.position += transform.velocity * dt;
-        // Update rotation
-        rotation.angle += rotation.speed * dt; // Increment rotation angle
-        if (rotation.angle >= 360.0f) rotation.angle -= 360.0f; // Wrap within [0, 360)
+    // Pattern bullets are swept over the step like entity bullets, against enemies no bullet claimed yet
+    const EntityVec& enemies = collisionWorld.colliders(CollisionLayer::Enemy);
+    bulletPatterns.forEachBullet(dt, [&](BulletPatternSystem::BulletRef ref, const Vec2<float>& from,
+                                         const Vec2<float>& to, float radius) {
+        collisionCounters.bulletTests += collisionWorld.sweepCircle(CollisionLayer::Enemy, from, to, radius, 0,
+                                                                    [&](size_t j, float) {
+            if (enemyClaimed[j]) {
+                return true;
+            }
+            enemyClaimed[j] = 1;
+            ++collisionCounters.bulletHits;
+
+            const auto& enemy = enemies[j];
+            const auto& enemyShape = enemy->get<CShape>();
+            events.emit(EnemyKilled{enemy->id(), patternBulletId, enemy->get<CTransform>().position,
+                                    enemyShape.radius, enemyShape.sides, enemyShape.color});
+            commands[0].destroyEntity(enemy);
+            bulletPatterns.kill(ref);
+            return false;
+        });
+    });
+}
+
+bool Game::handleContact(CollisionLayer query, CollisionLayer target, size_t i, size_t j) {
+    const auto& a = collisionWorld.colliders(query)[i];
+    const auto& b = collisionWorld.colliders(target)[j];
 
-        // Decrease lifespan
-        lifespan.remainingTime -= dt;
+    // Solid colliders push each other apart; triggers only report the contact
+    if (!a->get<CCollision>().isTrigger && !b->get<CCollision>().isTrigger) {
+        separateColliders(*a, *b);
+    }
 
-        // Fade out (reduce alpha over time)
-        sf::Color color = shape.color;
-        float alpha = (lifespan.remainingTime / lifespan.totalTime) * 255.0f; // Scale alpha
-        color.a = static_cast<int>(std::max(0.0f, alpha));
-        shape.color = color;
+    if (query == CollisionLayer::Player && target == CollisionLayer::Enemy) {
+        // Invincible players ignore every enemy; newly spawned enemies are harmless
+        if (a->get<CState>().isInvincible) {
+            return false;
+        }
+        if (b->get<CSpawnTime>().isProtected) {
+            return true;
+        }
+
+        // One hit per player per frame; the handler makes the player invincible
+        events.emit(PlayerHit{a->id(), b->id()});
+        return false;
+    }
 
-        // Destroy fragment if lifespan is over
-        if (lifespan.remainingTime <= 0.0f) {
-            fragment->destroy();
+    if (query == CollisionLayer::Bullet && target == CollisionLayer::Enemy) {
+        // Contacts come earliest first: the bullet kills the first enemy no other bullet claimed
+        if (enemyClaimed[j]) {
+            return true;
         }
+        enemyClaimed[j] = 1;
+        ++collisionCounters.bulletHits;
+
+        const auto& enemyShape = b->get<CShape>();
+        events.emit(EnemyKilled{b->id(), a->id(), b->get<CTransform>().position,
+                                enemyShape.radius, enemyShape.sides, enemyShape.color});
+        commands[0].destroyEntity(a);
+        commands[0].destroyEntity(b);
+        return false;
     }
+
+    return true;
 }
 
-void Game::updateCollisions() {
-    auto& players = entityManager.getEntities("player");
-    auto& enemies = entityManager.getEntities("enemy");
+void Game::separateColliders(Entity& a, Entity& b) {
+    auto& transform1 = a.get<CTransform>();
+    auto& transform2 = b.get<CTransform>();
 
-    for (auto& player : players) {
-        auto& playerTransform = player->get<CTransform>();
-        auto& playerCollision = player->get<CCollision>();
-        auto& playerState = player->get<CState>();
-        auto& playerShape = player->get<CShape>();
+    float dx = transform1.position.x - transform2.position.x;
+    float dy = transform1.position.y - transform2.position.y;
+    float collisionThreshold = a.get<CCollision>().radius + b.get<CCollision>().radius;
 
+    // The swept test also reports contacts earlier in the step; only push
+    // apart what still overlaps (earlier contacts may already have moved a)
+    float distanceSq = dx * dx + dy * dy;
+    if (distanceSq > collisionThreshold * collisionThreshold || distanceSq == 0.0f) {
+        return;
+    }
+    ++collisionCounters.enemyContacts;
+
+    // Separate the colliders to prevent sticking
+    float distance = std::sqrt(distanceSq);
+    float overlap = collisionThreshold - distance + 0.1f; // Add a small buffer
+    float nx = dx / distance; // Normalized x direction
+    float ny = dy / distance; // Normalized y direction
+
+    // Push both apart based on overlap
+    transform1.position.x += nx * (overlap / 2.0f);
+    transform1.position.y += ny * (overlap / 2.0f);
+    transform2.position.x -= nx * (overlap / 2.0f);
+    transform2.position.y -= ny * (overlap / 2.0f);
+
+    // Bounce: reverse both directions (processEnemyMovement keeps the speed at enemySpeed)
+    transform1.velocity = -transform1.velocity;
+    transform2.velocity = -transform2.velocity;
+}
 
-        for (auto& enemy : entityManager.getEntities("enemy")) {
-            auto& enemyTransform = enemy->get<CTransform>();
-            auto& enemyCollision = enemy->get<CCollision>();
-            auto& spawnTime = enemy->get<CSpawnTime>();
+// Events
 
-            // Skip collision if the enemy has just spawned
-            if (spawnTime.timeSinceSpawn < spawnProtectionTime) {
-                continue;
-            }
+void Game::processEvents() {
+    // Scoring
+    for (const auto& kill : events.get<EnemyKilled>()) {
+        totalPoints += kill.sides * 100; // reward 100 point per side
+    }
 
-            // Calculate distance
-            float dx = playerTransform.position.x - enemyTransform.position.x;
-            float dy = playerTransform.position.y - enemyTransform.position.y;
-            float distance = std::sqrt(dx * dx + dy * dy);
-
-            // Check if the distance is less than or equal to the sum of their radii
-            float collisionThreshold = playerCollision.radius + enemyCollision.radius;
-
-            if (distance <= collisionThreshold) {
-                // Skip collision logic if the player is invincible
-                if (playerState.isInvincible) {
-                    continue;
-                }
-
-                // Reduce lives
-                playerLives--;
-
-                //If Lives <=0 
-                if (playerLives <= 0) {
-                    handlePlayerDeath(totalPoints, playerShape.sides);
-                }
-
-                // Reset player position and enable invincibility
-                playerTransform.position = {
-                    static_cast<float>(window.getSize().x) / 2.0f,
-                    static_cast<float>(window.getSize().y) / 2.0f
-                };
-                playerState.isInvincible = true; // Make the player invincible
-                playerState.invincibilityTimer = playerInvincibilityTime; // Set invincibility duration
-            }
-        }
+    // Effects
+    for (const auto& kill : events.get<EnemyKilled>()) {
+        explodeEnemy(kill);
     }
-    // Handle enemy-enemy collisions
-    for (size_t i = 0; i < entityManager.getEntities("enemy").size(); ++i) {
-        auto& enemy1 = enemies[i];
-        auto& transform1 = enemy1->get<CTransform>();
-        auto& collision1 = enemy1->get<CCollision>();
-
-        for (size_t j = i + 1; j < enemies.size(); ++j) {
-            auto& enemy2 = enemies[j];
-            auto& transform2 = enemy2->get<CTransform>();
-            auto& collision2 = enemy2->get<CCollision>();
-
-            // Calculate distance
-            float dx = transform1.position.x - transform2.position.x;
-            float dy = transform1.position.y - transform2.position.y;
-            float distance = std::sqrt(dx * dx + dy * dy);
-
-            // Check for collision
-            float collisionThreshold = collision1.radius + collision2.radius;
-            if (distance <= collisionThreshold) {
-                // Separate the enemies to prevent sticking
-                float overlap = collisionThreshold - distance + 0.1f; // Add a small buffer
-                float nx = dx / distance; // Normalized x direction
-                float ny = dy / distance; // Normalized y direction
-
-                // Push enemies apart based on overlap
-                transform1.position.x += nx * (overlap / 2.0f);
-                transform1.position.y += ny * (overlap / 2.0f);
-                transform2.position.x -= nx * (overlap / 2.0f);
-                transform2.position.y -= ny * (overlap / 2.0f);
-
-                // Adjust velocities for bounce
-                transform1.velocity.x = -transform1.velocity.x * 1.3f; // Add a slight speed boost
-                transform1.velocity.y = -transform1.velocity.y * 1.3f;
-
-                transform2.velocity.x = -transform2.velocity.x * 1.3f;
-                transform2.velocity.y = -transform2.velocity.y * 1.3f;
-            } else {
-                // Reset velocity to original speed when not in collision
-                // Normalize and scale velocity to ensure consistent speed
-                float magnitude1 = std::sqrt(transform1.velocity.x * transform1.velocity.x + transform1.velocity.y * transform1.velocity.y);
-                if (magnitude1 > 0) {
-                    transform1.velocity.x = (transform1.velocity.x / magnitude1) * enemySpeed;
-                    transform1.velocity.y = (transform1.velocity.y / magnitude1) * enemySpeed;
-                }
-
-                float magnitude2 = std::sqrt(transform2.velocity.x * transform2.velocity.x + transform2.velocity.y * transform2.velocity.y);
-                if (magnitude2 > 0) {
-                    transform2.velocity.x = (transform2.velocity.x / magnitude2) * enemySpeed;
-                    transform2.velocity.y = (transform2.velocity.y / magnitude2) * enemySpeed;
-                }
-            }
-        }
-        // Manage enemy-bullet collision        
-        for (auto& bullet : entityManager.getEntities("bullet")) {
-            auto& bulletTransform = bullet->get<CTransform>();
 
-            for (auto& enemy : entityManager.getEntities("enemy")) {
-                auto& enemyTransform = enemy->get<CTransform>();
-                auto& enemyShape = enemy->get<CShape>();
-
-                // Check if the bullet hits the enemy
-                float dx = bulletTransform.position.x - enemyTransform.position.x;
-                float dy = bulletTransform.position.y - enemyTransform.position.y;
-                float distance = std::sqrt(dx * dx + dy * dy);
-
-                float collisionThreshold = enemyShape.radius; // Bullet is small
-                if (distance <= collisionThreshold) {
-                    bullet->destroy(); // Destroy the bullet
-                    explodeEnemy(enemy); // Trigger enemy explosion
-                    totalPoints += enemyShape.sides*100; // reward 100 point per side
-                    break; // Exit the loop since the bullet is destroyed
-                }
-            }
-        }        
+    // Misses, for the soak log (bullets that hit something never expire)
+    expiredBullets = events.get<BulletExpired>().size();
+
+    // Player damage
+    for (const auto& hit : events.get<PlayerHit>()) {
+        handlePlayerHit(hit);
     }
 
-}
+    // Wave scripts waiting for kills or hits
+    for (const auto& kill : events.get<EnemyKilled>()) {
+        scripts.publish(kill);
+    }
+    for (const auto& hit : events.get<PlayerHit>()) {
+        scripts.publish(hit);
+    }
 
-void Game::updatePlayer(float dt) {
-    auto& player = entityManager.getEntities("player").front(); // Get the player entity
-    auto& transform = player->get<CTransform>();
-    auto& shape = player->get<CShape>();
-    auto& state = player->get<CState>();
-    auto& input = player->get<CInput>();
-    auto& rotation = player->get<CRotation>(); // Get rotation component
+    events.clear();
+}
 
-    // Movement logic based on the input component
-    Vec2<float> velocity(0.0f, 0.0f);
-    if (input.up) velocity.y -= playerSpeed;
-    if (input.down) velocity.y += playerSpeed;
-    if (input.left) velocity.x -= playerSpeed;
-    if (input.right) velocity.x += playerSpeed;
+void Game::handlePlayerHit(const PlayerHit& hit) {
+    for (auto& player : entityManager.getEntities("player")) {
+        if (player->id() != hit.playerId) {
+            continue;
+        }
+        auto& playerTransform = player->get<CTransform>();
+        auto& lives = player->modify<CLives>();
 
-    transform.position += velocity * dt;
+        // Reduce lives
+        lives.remaining--;
 
-    // Keep the player within screen boundaries
-    transform.position.x = std::clamp(transform.position.x, shape.radius, static_cast<float>(window.getSize().x) - shape.radius);
-    transform.position.y = std::clamp(transform.position.y, shape.radius, static_cast<float>(window.getSize().y) - shape.radius);
+        //If Lives <=0 (players share one fate: the session ends for everyone)
+        if (lives.remaining <= 0) {
+            auto local = localPlayer();
+            handlePlayerDeath(totalPoints, (local ? local : player)->get<CShape>().sides);
+        }
 
-    // Update rotation logic
-    rotation.angle += rotation.speed * dt; // Increment rotation angle
-    if (rotation.angle >= 360.0f) {
-        rotation.angle -= 360.0f; // Wrap around to keep within [0, 360)
+        // Reset player position and enable invincibility
+        playerTransform.position = playerSpawnPoint(player->get<CInput>().slot);
+        playerTransform.prevPosition = playerTransform.position; // Teleport, not a sweep across the world
+        // Invincible from the sync point that ends this update (handleContact already
+        // took at most one hit per player this update)
+        commands[0].addComponent<CState>(player, true, timers.now() + playerInvincibilityTime);
+        timers.schedule(playerInvincibilityTime, TimerExpired{TimerExpired::Invincibility, player});
     }
+}
 
-    // Handle invincibility
-    if (state.isInvincible) {
-        state.invincibilityTimer -= dt;
-        if (state.invincibilityTimer <= 0.0f) {
-            state.isInvincible = false;
-            state.invincibilityTimer = 0.0f;
+void Game::updatePlayer(float dt) {
+    for (auto& player : entityManager.getEntities("player")) {
+        auto& transform = player->get<CTransform>();
+        auto& shape = player->get<CShape>();
+        auto& input = player->get<CInput>();
+        auto& rotation = player->get<CRotation>(); // Get rotation component
+
+        // Movement logic based on the input component (direction averaged over the step,
+        // so a key pressed mid-frame only moves the player for the part it was held)
+        Vec2<float> velocity = input.move * playerSpeed;
+
+        transform.prevPosition = transform.position; // Start of the step for swept collision
+        transform.position += velocity * dt;
+
+        // Keep the player within screen boundaries
+        transform.position.x = std::clamp(transform.position.x, shape.radius, worldWidth - shape.radius);
+        transform.position.y = std::clamp(transform.position.y, shape.radius, worldHeight - shape.radius);
+
+        // Update rotation logic
+        rotation.angle += rotation.speed * dt; // Increment rotation angle
+        if (rotation.angle >= 360.0f) {
+            rotation.angle -= 360.0f; // Wrap around to keep within [0, 360)
         }
     }
 }
@@ -478,23 +1141,27 @@ void Game::updatePlayer(float dt) {
 // Rendering
 
 void Game::render() {
-    window.clear(sf::Color::Black);
+    window->clear(sf::Color::Black);
     // Draw entities if the game is still playing
     if (gameState == GameState::Playing) {
 
-        // Render bullets
+        // Everything below is culled against the world rectangle (the window) and
+        // drawn with as many sides as its size on screen needs
+        RenderView view{0.0f, 0.0f, worldWidth, worldHeight};
+
+        // Render bullets (white fill, outline in the bullet's color) in one draw call
+        bulletVertices.clear();
         for (auto& bullet : entityManager.getEntities("bullet")) {
             auto& transform = bullet->get<CTransform>();
             auto& shape = bullet->get<CShape>();
-
-            sf::CircleShape bulletShape(shape.radius, shape.sides); // Match bullet shape
-            bulletShape.setOrigin(shape.radius, shape.radius);      // Center the shape
-            bulletShape.setFillColor(sf::Color::White);             // White inner color
-            bulletShape.setOutlineThickness(2.0f);                 // Set outline thickness
-            bulletShape.setOutlineColor(shape.color);              // Match player outline color
-            bulletShape.setPosition(transform.position.x, transform.position.y);
-
-            window.draw(bulletShape);
+            if (!view.visible(transform.position.x, transform.position.y, shape.radius + 2.0f)) {
+                continue;
+            }
+            appendOutlinedCircle(bulletVertices, transform.position.x, transform.position.y, shape.radius,
+                                 circleSides(shape.radius + 2.0f, shape.sides), 2.0f, sf::Color::White, shape.color);
+        }
+        if (!bulletVertices.empty()) {
+            window->draw(bulletVertices.data(), bulletVertices.size(), sf::Triangles);
         }
 
         // Render the player
@@ -508,7 +1175,7 @@ void Game::render() {
             bool renderPlayer = true; // Default: always render
             if (playerState.isInvincible) {
                 [[maybe_unused]] int blinkInterval = 200; // Milliseconds
-                [[maybe_unused]] int currentTime = static_cast<int>(playerState.invincibilityTimer * 1000); // Convert to ms
+                [[maybe_unused]] int currentTime = static_cast<int>((playerState.invincibleUntil - timers.now()) * 1000); // Remaining ms
                 renderPlayer = (currentTime / blinkInterval) % 2 == 0; // Toggle visibility
             }
 
@@ -522,7 +1189,7 @@ void Game::render() {
                 circle.setOutlineColor(shape.color);         // White outline
                 circle.setPosition(transform.position.x ,
                                 transform.position.y);
-                window.draw(circle);
+                window->draw(circle);
 
                 // Render the outer shape
                 sf::CircleShape polygon(shape.radius, shape.sides); // Set radius and sides
@@ -533,41 +1200,35 @@ void Game::render() {
                 polygon.setRotation(rotation.angle); 
                 polygon.setPosition(transform.position.x,
                                     transform.position.y);
-                window.draw(polygon);
+                window->draw(polygon);
             }
         }
-        // Render the enemies
+        // Render the enemies from their cached collision outlines in one draw call
+        enemyVertices.clear();
+        float enemyOutline = 4.0f * quality.settings().outlineScale;
         for (auto& entity : entityManager.getEntities("enemy")) {
-            auto& transform = entity->get<CTransform>();
-            auto& shape = entity->get<CShape>();
-            auto& rotation = entity->get<CRotation>();
-
-            sf::CircleShape polygon(shape.radius, shape.sides);
-            polygon.setOrigin(shape.radius, shape.radius);      
-            polygon.setFillColor(sf::Color::Black);            
-            polygon.setOutlineThickness(4.0f);                
-            polygon.setOutlineColor(shape.color);            
-            polygon.setRotation(rotation.angle); 
-            polygon.setPosition(transform.position.x, 
-                                transform.position.y); // Adjust for origin
-
-            
-            window.draw(polygon);
-        }
-        // Render fragments
-        for (auto& fragment : entityManager.getEntities("fragment")) {
-            auto& transform = fragment->get<CTransform>();
-            auto& shape = fragment->get<CShape>();
-            auto& rotation = fragment->get<CRotation>();
-
-            sf::CircleShape fragmentShape(shape.radius, shape.sides); // Same shape type as enemy
-            fragmentShape.setOrigin(shape.radius, shape.radius);
-            fragmentShape.setFillColor(sf::Color::Transparent); // Transparent fill
-            fragmentShape.setOutlineThickness(3.0f);
-            fragmentShape.setRotation(rotation.angle); 
-            fragmentShape.setOutlineColor(shape.color);
-            fragmentShape.setPosition(transform.position.x, transform.position.y);
-            window.draw(fragmentShape);
+            const auto& position = entity->get<CTransform>().position;
+            auto& polygon = entity->get<CPolygon>();
+            if (!view.visible(position.x, position.y, polygon.radius + 2.0f * enemyOutline)) {
+                continue; // A triangle's mitered corner reaches radius + 2 * thickness
+            }
+            const PolygonShape& outline = polygon.refresh(entity->get<CRotation>().angle);
+            appendOutlinedPolygon(enemyVertices, position, outline, enemyOutline, sf::Color::Black, entity->get<CShape>().color);
+        }
+        if (!enemyVertices.empty()) {
+            window->draw(enemyVertices.data(), enemyVertices.size(), sf::Triangles);
+        }
+        // Render fragments straight from the particle arrays in one draw call
+        particleVertices.clear();
+        particles.appendVertices(particleVertices, 3.0f * quality.settings().outlineScale, view);
+        if (!particleVertices.empty()) {
+            window->draw(particleVertices.data(), particleVertices.size(), sf::Triangles);
+        }
+        // Render pattern bullets from their closed form, also in one draw call
+        patternVertices.clear();
+        bulletPatterns.appendVertices(patternVertices, view, quality.settings().bulletSides);
+        if (!patternVertices.empty()) {
+            window->draw(patternVertices.data(), patternVertices.size(), sf::Triangles);
         }
         for (auto& clone : entityManager.getEntities("clone")) {
             auto& transform = clone->get<CTransform>();
@@ -580,48 +1241,43 @@ void Game::render() {
             cloneShape.setOutlineColor(shape.color); // Updated color with alpha
             cloneShape.setPosition(transform.position.x, transform.position.y);
 
-            window.draw(cloneShape);
+            window->draw(cloneShape);
         }
 
-        // Render HUD
-        sf::Text supermoveDisplay;
-        supermoveDisplay.setFont(font); // Ensure the font is loaded
-        supermoveDisplay.setCharacterSize(20); // Set font size
-        supermoveDisplay.setFillColor(sf::Color::White); // Text color
-
-        // Set the text based on supermove readiness
-        if (supermoveReady) {
-            supermoveDisplay.setString("Supermove: READY");
-        } else {
-            supermoveDisplay.setString("Supermove: Available in " + std::to_string(static_cast<int>(std::ceil(supermoveTimer))) + "s");
-        }
-
-        // Position the text in the bottom-right corner
-        sf::FloatRect textBounds = supermoveDisplay.getLocalBounds();
-        supermoveDisplay.setPosition(
-            static_cast<float>(window.getSize().x) - textBounds.width - 20.0f, // Align right
-            static_cast<float>(window.getSize().y) - textBounds.height - 20.0f // Align bottom
-        );
-        window.draw(supermoveDisplay);
+        // Render HUD (texts are laid out by updateHUD)
+        window->draw(supermoveDisplay);
     }
 
-    window.draw(livesText);
-    window.draw(pointsText);
-    window.draw(bestScoreText);
+    window->draw(livesText);
+    window->draw(pointsText);
+    window->draw(bestScoreText);
+
+    // Show the lobby status until every player has joined
+    if (session && !session->started()) {
+        sf::Text waitingText;
+        waitingText.setFont(font);
+        waitingText.setCharacterSize(30);
+        waitingText.setFillColor(sf::Color::White);
+        waitingText.setString(session->isHost() ? "Waiting for players..." : "Connecting to host...");
+        sf::FloatRect waitingBounds = waitingText.getLocalBounds();
+        waitingText.setOrigin(waitingBounds.width / 2, waitingBounds.height / 2);
+        waitingText.setPosition(static_cast<float>(window->getSize().x) / 2,
+                                static_cast<float>(window->getSize().y) / 2);
+        window->draw(waitingText);
+    }
 
     // Draw Game Over message if the game is over
    if (gameState == GameState::GameOver) {
-        window.draw(gameOverText);
+        window->draw(gameOverText);
     }
-    window.display();
+    presentStart = InputSampler::Clock::now(); // Drawing done; run() waits out the frame after this
+    window->display();
 }
 
 void Game::initializeHUD() {
-    // Load a font
-    if (!font.loadFromFile("src/font/font.ttf")) {
-        std::cerr << "Failed to load font!" << std::endl;
-        return;
-    }
+    // Load the font (embedded in the binary unless --font maps a file instead)
+    std::string fontSource = loadFont(font, fontMapping, options.fontPath);
+    startupTimeline.mark("font (" + fontSource + ")");
 
     // Initialize Score text
     bestScoreText.setFont(font);
@@ -632,7 +1288,7 @@ void Game::initializeHUD() {
     livesText.setFont(font);
     livesText.setCharacterSize(20); 
     livesText.setFillColor(sf::Color::White); 
-    livesText.setPosition(10, window.getSize().y - 40); // Bottom left position
+    livesText.setPosition(10, window->getSize().y - 40); // Bottom left position
     livesText.setString("Lives Remaining: " + std::to_string(playerLives));
 
     // Initialize points text
@@ -649,25 +1305,50 @@ void Game::initializeHUD() {
 }
 
 void Game::updateHUD() {
+    // The HUD always follows the local player. Texts are only rebuilt when what
+    // they show changed: lives and shape through the player's change stamps,
+    // points and the supermove countdown by value.
+    auto player = localPlayer();
+    size_t playerId = player ? player->id() : SIZE_MAX;
+    bool newPlayer = playerId != hudPlayerId;
+    uint64_t seen = hudTick;
+    hudPlayerId = playerId;
+    hudTick = entityManager.tick();
+
     // === Supermove Status ===
-    if (supermoveReady) {
-        supermoveDisplay.setString("Supermove: READY");
-    } else {
-        supermoveDisplay.setString("Supermove: Available in " + std::to_string(static_cast<int>(std::ceil(supermoveTimer))) + "s");
+    double supermoveLeft = player ? player->get<CWeapon>().supermoveReadyTime - timers.now() : 0.0;
+    int supermoveSeconds = supermoveLeft > 0.0 ? static_cast<int>(std::ceil(supermoveLeft)) : 0;
+    if (newPlayer || supermoveSeconds != hudSupermoveSeconds) {
+        hudSupermoveSeconds = supermoveSeconds;
+        if (supermoveSeconds == 0) {
+            supermoveDisplay.setString("Supermove: READY");
+        } else {
+            supermoveDisplay.setString("Supermove: Available in " + std::to_string(supermoveSeconds) + "s");
+        }
+        // Bottom-right corner
+        sf::FloatRect textBounds = supermoveDisplay.getLocalBounds();
+        supermoveDisplay.setPosition(
+            static_cast<float>(window->getSize().x) - textBounds.width - 20.0f,
+            static_cast<float>(window->getSize().y) - textBounds.height - 20.0f
+        );
     }
-    supermoveDisplay.setPosition(static_cast<float>(window.getSize().x) - 250.0f, static_cast<float>(window.getSize().y) - 50.0f);
 
     // === Player Lives Display ===
-    livesText.setString("Lives Remaining: " + std::to_string(playerLives));
-    livesText.setPosition(20.0f, static_cast<float>(window.getSize().y) - 50.0f);
+    if (newPlayer || (player && player->changedSince<CLives>(seen))) {
+        livesText.setString("Lives Remaining: " + std::to_string(player ? player->get<CLives>().remaining : 0));
+        livesText.setPosition(20.0f, static_cast<float>(window->getSize().y) - 50.0f);
+    }
 
     // === Points Display ===
-    pointsText.setString("Points: " + std::to_string(totalPoints));
-    pointsText.setPosition(20.0f, 20.0f);
+    if (newPlayer || totalPoints != hudPoints) {
+        hudPoints = totalPoints;
+        pointsText.setString("Points: " + std::to_string(totalPoints));
+        pointsText.setPosition(20.0f, 20.0f);
+    }
 
     // === Best Score Display ===
-    if (!entityManager.getEntities("player").empty()) {
-        auto& player = entityManager.getEntities("player").front();
+    // Best scores only change at a game over, which brings a new player
+    if (player && (newPlayer || player->changedSince<CShape>(seen))) {
         int shapeSides = player->get<CShape>().sides;
         std::string shapeName = getShapeName(shapeSides);
 
@@ -687,74 +1368,126 @@ void Game::initializeGameOverText() {
     // Center the text in the middle of the screen
     sf::FloatRect textBounds = gameOverText.getLocalBounds();
     gameOverText.setOrigin(textBounds.width / 2, textBounds.height / 2);
-    gameOverText.setPosition(static_cast<float>(window.getSize().x) / 2,
-                             static_cast<float>(window.getSize().y) / 2);
+    gameOverText.setPosition(static_cast<float>(window->getSize().x) / 2,
+                             static_cast<float>(window->getSize().y) / 2);
 }
 
 // Spawning
 
-void Game::spawnEnemies(float dt) {
-    enemySpawnTimer += dt;
-    if (enemySpawnTimer >= enemySpawnInterval) {
-        if (entityManager.countEntities("enemy") < maxEnemyPerFrame) {
-            auto enemy = entityManager.addEntity("enemy");
-
-            float x = getRandom<float>(enemyRadius, static_cast<float>(window.getSize().x) - enemyRadius);
-            float y = getRandom<float>(enemyRadius, static_cast<float>(window.getSize().y) - enemyRadius);
+void Game::seedRandom(uint64_t seed, uint32_t substream) {
+    // Every stream restarts from the same seed; the stream ids keep their sequences
+    // apart, and substreams keep games that share a seed (parallel environments) apart
+    spawnRandom = RandomStream(seed, RandomStreamId::Spawns).substream(substream);
+    colorRandom = RandomStream(seed, RandomStreamId::Colors).substream(substream);
+}
 
-            float angle = getRandom<float>(0.0f, 360.0f);
-            float radian = angle * (3.14159265f / 180.0f);
-            Vec2<float> velocity = Vec2<float>(std::cos(radian), std::sin(radian)) * enemySpeed;
-            enemy->add<CTransform>(Vec2<float>(x, y), velocity);
+std::shared_ptr<Entity> Game::spawnEnemy(const Vec2<float>& position, const Vec2<float>& velocity, int sides) {
+    auto enemy = entityManager.addEntity("enemy");
+    enemy->add<CTransform>(position, velocity);
 
+    sf::Color EnemyColor = getRandomBrightColor(colorRandom);
+    enemy->add<CShape>(sides, enemyRadius, sf::Color(EnemyColor));
+    enemy->add<CRotation>(0.0f, enemyRotationSpeed);
+    enemy->add<CCollision>(enemyRadius, CollisionLayer::Enemy, true, false); // Solid: enemies push each other apart
+    enemy->add<CPolygon>(sides, enemyRadius);
 
-            sf::Color EnemyColor = getRandomBrightColor();
-            enemy->add<CShape>(getRandom<int>(3, 8), enemyRadius, sf::Color(EnemyColor));
-            enemy->add<CRotation>(0.0f, enemyRotationSpeed);
-            enemy->add<CCollision>(enemyRadius, true, true);
+    // Add the spawn time component; protection ends on a timer
+    enemy->add<CSpawnTime>(timers.now());
+    timers.schedule(spawnProtectionTime, TimerExpired{TimerExpired::SpawnProtection, enemy});
+    return enemy;
+}
 
-            // Add the spawn time component
-            enemy->add<CSpawnTime>();
-            enemySpawnTimer = 0.0f;
-        }
+SpawnPlacer& Game::spawnPlacement() {
+    // Points placed earlier in the same update stay occupied (those enemies are not in the manager yet)
+    if (spawnPlacerTick != entityManager.tick()) {
+        spawnPlacer.enemySpacing = enemySpawnSpacing;
+        spawnPlacer.playerClearance = spawnPlayerClearance;
+        spawnPlacer.begin(entityManager.getEntities("enemy"), entityManager.getEntities("player"), worldWidth, worldHeight);
+        spawnPlacerTick = entityManager.tick();
     }
+    return spawnPlacer;
 }
 
-// Explosions
+void Game::spawnRandomEnemy() {
+    // Somewhere clear of the players and the other enemies
+    Vec2<float> position = spawnPlacement().place(spawnRandom, Vec2<float>(enemyRadius, enemyRadius),
+                                                  Vec2<float>(worldWidth - enemyRadius, worldHeight - enemyRadius));
 
-void Game::explodeEnemy(std::shared_ptr<Entity> enemy) {
-    auto& enemyTransform = enemy->get<CTransform>();
-    auto& enemyShape = enemy->get<CShape>();
+    float angle = getRandom<float>(spawnRandom, 0.0f, 360.0f);
+    float radian = angle * (3.14159265f / 180.0f);
+    Vec2<float> velocity = Vec2<float>(std::cos(radian), std::sin(radian)) * enemySpeed;
+    spawnEnemy(position, velocity, getRandom<int>(spawnRandom, 3, 8));
+}
 
-    // Get the center position and radius of the enemy
-    Vec2<float> center = enemyTransform.position;
-    float radius = enemyShape.radius;
-    int sides = enemyShape.sides;
-    sf::Color color = enemyShape.color;
+void Game::spawnRing(int count, int sides, float radius) {
+    // Centered on the first player (the same one on every peer of a session, unlike
+    // the local player) or the middle of the world, pulled in so the ring fits
+    auto player = playerInSlot(0);
+    Vec2<float> center = player ? player->get<CTransform>().position : Vec2<float>(worldWidth / 2.0f, worldHeight / 2.0f);
+    center.x = std::clamp(center.x, radius + enemyRadius, std::max(radius + enemyRadius, worldWidth - radius - enemyRadius));
+    center.y = std::clamp(center.y, radius + enemyRadius, std::max(radius + enemyRadius, worldHeight - radius - enemyRadius));
+
+    std::vector<Vec2<float>> directions, slots, positions;
+    for (int i = 0; i < count; ++i) {
+        float radian = static_cast<float>(i) * (2.0f * 3.14159265f / static_cast<float>(count));
+        directions.emplace_back(std::cos(radian), std::sin(radian));
+        slots.push_back(center + directions.back() * radius);
+    }
 
-    // Destroy the original enemy
-    enemy->destroy();
+    // Each slot moves (by up to an enemy radius) only if another enemy already sits there
+    Vec2<float> min(enemyRadius, enemyRadius), max(worldWidth - enemyRadius, worldHeight - enemyRadius);
+    spawnPlacement().placeMany(spawnRandom, slots, enemyRadius, min, max, positions);
+    for (int i = 0; i < count; ++i) {
+        spawnEnemy(positions[i], directions[i] * -enemySpeed, sides); // Closing in
+    }
+}
 
-    // Generate fragments
-    for (int i = 0; i < sides; i++) {
-        // Calculate angle for each fragment
-        float angle = (2.0f * M_PI / sides) * i;
+// Wave Scripts
 
-        // Calculate direction vector for the fragment
-        Vec2<float> direction(std::cos(angle), std::sin(angle));
+void Game::startWaveScripts() {
+    scripts.clear();
+    scripts.start(enemyStream());
+    scripts.start(ringWaves());
+}
 
-        // Spawn a new fragment
-        auto fragment = entityManager.addEntity("fragment");
-        Vec2<float> fragmentVelocity = direction * fragmentSpeed; // Assign outward velocity
+ScriptTask Game::enemyStream() {
+    // One random enemy every enemySpawnInterval, while fewer than maxEnemyPerFrame are alive
+    for (;;) {
+        co_await scripts.wait(enemySpawnInterval);
+        co_await scripts.until([this] { return entityManager.countEntities("enemy") < maxEnemyPerFrame; });
+        spawnRandomEnemy();
+    }
+}
 
-        // Fragments are smaller shapes with reduced radius
-        fragment->add<CTransform>(center, fragmentVelocity);
-        fragment->add<CShape>(sides, radius / 2.0f, color);  // Smaller radius
-        fragment->add<CLifeSpan>(fragmentLifeTime);
-        fragment->add<CRotation>(0.0f, enemyRotationSpeed); 
+ScriptTask Game::ringWaves() {
+    // Every ringWaveInterval, once the field has thinned out, a ring of hexagons
+    // closes in on the player; the next one waits until half of it is shot down
+    for (;;) {
+        co_await scripts.wait(ringWaveInterval);
+        co_await scripts.until([this] { return entityManager.countEntities("enemy") < 5; });
+        spawnRing(ringWaveSize, 6, ringWaveRadius);
+        for (int kills = 0; kills < ringWaveSize / 2; ++kills) {
+            co_await scripts.next<EnemyKilled>();
+        }
     }
 }
 
+// Explosions
+
+void Game::explodeEnemy(const EnemyKilled& kill) {
+    // Get the center position and radius of the enemy
+    Vec2<float> center = kill.position;
+    float radius = kill.radius;
+    int sides = kill.sides;
+    sf::Color color = kill.color;
+
+    // Generate fragments: one particle per side flying outward (fewer and shorter lived under load)
+    const QualityLevel& level = quality.settings();
+    int fragments = std::max(1, static_cast<int>(std::lround(sides * level.fragmentScale)));
+    particles.spawnBurst(center, fragments, fragmentSpeed, radius / 2.0f, sides, color,
+                         fragmentLifeTime * level.fragmentLifeScale, enemyRotationSpeed);
+}
+
 // Game-Specific Logic
 
 void Game::processEnemyMovement(float dt) {
@@ -763,14 +1496,18 @@ void Game::processEnemyMovement(float dt) {
         auto& shape = entity->get<CShape>();
         auto& rotation = entity->get<CRotation>();
 
-        // Update position using velocity
+        // Back to the normal speed after a bounce (a stopped enemy stays stopped)
+        transform.velocity = transform.velocity.normalize() * enemySpeed; // Exact: lockstep peers must agree bit for bit
+
+        // Update position using velocity, keeping the start of the step for swept collision
+        transform.prevPosition = transform.position;
         transform.position += transform.velocity * dt;
 
         // Reverse direction if the enemy hits a boundary (considering radius)
-        if (transform.position.x - shape.radius <= 0 || transform.position.x + shape.radius >= window.getSize().x) {
+        if (transform.position.x - shape.radius <= 0 || transform.position.x + shape.radius >= worldWidth) {
             transform.velocity.x = -transform.velocity.x; // Reverse X direction
         }
-        if (transform.position.y - shape.radius <= 0 || transform.position.y + shape.radius >= window.getSize().y) {
+        if (transform.position.y - shape.radius <= 0 || transform.position.y + shape.radius >= worldHeight) {
             transform.velocity.y = -transform.velocity.y; // Reverse Y direction
         }
 
@@ -783,6 +1520,12 @@ void Game::processEnemyMovement(float dt) {
 }
 
 void Game::handlePlayerDeath(int currentScore, int shapeSides) {
+    // Bot runs and training environments never touch the player's best scores
+    if (bot || options.simulationOnly) {
+        gameState = GameState::GameOver;
+        return;
+    }
+
     std::string shapeName = getShapeName(shapeSides);
     std::cout << "Shape: " << shapeName << "\n";
 
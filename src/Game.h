@@ -1,8 +1,36 @@
+#pragma once
+
 #include <SFML/Graphics.hpp>
 #include "EntityManager.hpp"
 #include "Components.hpp"
-#include <cstdlib> // For rand()
-#include <ctime>   // For seeding rand() with time
+#include "Collision.hpp"
+#include "CollisionKernel.hpp"
+#include "CollisionWorld.hpp"
+#include "Events.hpp"
+#include "CommandBuffer.hpp"
+#include "ParticleSystem.hpp"
+#include "BulletPatterns.hpp"
+#include "RenderCulling.hpp"
+#include "Assets.hpp"
+#include "GameOptions.hpp"
+#include "StartupTimeline.hpp"
+#include "LockstepSession.hpp"
+#include "InputSampler.hpp"
+#include "FrameStats.hpp"
+#include "BotController.hpp"
+#include "SoakRecorder.hpp"
+#include "Telemetry.hpp"
+#include "QualityGovernor.hpp"
+#include "TimingWheel.hpp"
+#include "ScriptScheduler.hpp"
+#include "RandomStream.hpp"
+#include "SpawnPlacer.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+#include <ctime>   // For seeding the random engine with time
 
 // Enum representing the current game state
 enum class GameState {
@@ -13,29 +41,109 @@ enum class GameState {
 // Main Game Class
 class Game {
 public:
-    Game();                // Constructor
+    explicit Game(const GameOptions& options = {}); // Constructor
     ~Game();               // Destructor
 
     void run();            // Main game loop
+    int exitCode() const { return m_exitCode; } // Non-zero when a latency budget was exceeded
+
+    // === Training Episodes (simulation-only instances, see GameEnv.h) ===
+    void resetEpisode(uint64_t seed, uint32_t substream = 0); // Fresh world with one player, seeded for repeatable episodes
+    void stepEpisode(const PlayerInput& action, float dt); // One fixed step with the player's input for it
+    void observe(float* out);                 // Writes envObservationSize floats describing the world
+    int score() const { return totalPoints; }
+    int lastStepPoints() const { return stepPoints; }
+    Vec2<float> worldSize() const { return Vec2<float>(worldWidth, worldHeight); }
+    bool episodeOver() const { return gameState == GameState::GameOver; }
+
+    // === Balance Sweeps (simulation-only instances, see tools/balance_sweep.cpp) ===
+    bool setTunable(const std::string& name, double value); // Overrides a balance knob below by its member name; false if unknown
+    static std::vector<std::string> tunableNames();         // Every knob setTunable accepts
+    void stepBotEpisode(BotController& driver, float dt);    // One fixed step with the bot playing the player
+    size_t entityCount() { return entityManager.getEntities().size(); }
+
+    // === Lockstep Loopback (simulation-only instances, see tools/lockstep_loopback.cpp) ===
+    void joinSession(std::unique_ptr<LockstepSession> peer); // Plays this peer of a session (the world starts empty)
+    void setScriptedInput(std::function<PlayerInput(uint32_t tick)> input) { scriptedInput = std::move(input); } // Local input per tick
+    void stepNetwork(float dt) { updateNetwork(dt); }        // One frame of lockstep ticks
+    const LockstepSession* networkSession() const { return session.get(); }
+    const std::vector<uint64_t>& networkChecksums() const { return tickChecksums; } // stateChecksum() after each tick
+    uint64_t stateChecksum();                                // Hash of the exact simulation state (desync detection)
 
 private:
     // === Game State ===
     GameState gameState = GameState::Playing; // Tracks the current state of the game
+    GameOptions options;                      // Command line options
+    StartupTimeline startupTimeline;          // Startup phases, timed from when this Game is constructed
+
+    // === Frame Timing ===
+    void stop();                              // Ends run() after the current frame (closes the window if there is one)
+    bool running = true;                      // run() keeps going until stop()
+    void writeLatencyReport();                // Writes the latency percentiles to --latency-report
+    void finishLatencyReport();               // Final report and latency budget check
+    FrameStats frameStats;                    // Frame, sim, render and input-to-present histograms
+    InputSampler::Clock::time_point oldestInputTime{}; // Earliest input event not yet presented
+    bool inputPending = false;                // oldestInputTime is set
+    int m_exitCode = 0;
+    QualityGovernor quality;                  // Sheds visual detail and solver work when frames run over budget
+    InputSampler::Clock::time_point presentStart; // When render() finished drawing (before the frame limit wait)
+    static constexpr auto frameInterval = std::chrono::microseconds(1000000 / 60); // Frame limit (input is sampled while waiting)
+    float hudTimer = 0.0f;                    // Seconds since the HUD text was last refreshed
+    uint64_t hudTick = 0;                     // EntityManager tick of the last HUD refresh
+    size_t hudPlayerId = SIZE_MAX;            // Player the HUD texts were built for
+    int hudPoints = -1;                       // Points shown by pointsText
+    int hudSupermoveSeconds = -1;             // Countdown shown by supermoveDisplay (0 = ready)
+    uint64_t collisionSteps = 0;              // updateCollisions calls (paces the enemy-enemy solver)
+
+    // === Bot Runs ===
+    void updateBot();                         // Bot-driven fixed steps, timeScale per frame
+    void restartGame();                       // Starts over after a game over (soak runs never stop)
+    std::unique_ptr<BotController> bot;       // Replaces keyboard/mouse with --bot
+    SoakRecorder soakRecorder;                // Per-second CSV of entity counts, collision work and step cost
+    CollisionCounters collisionCounters;      // Work done by the last updateCollisions
+    size_t expiredBullets = 0;                // BulletExpired events the last processEvents handled
+    TelemetryRecorder telemetry;              // World samples streamed to --telemetry on a writer thread
+    float botStepDt = 1.0f / 60.0f;           // Fixed simulation step in bot runs
+    float botTime = 0.0f;                     // Simulated seconds since the bot run started
+
+    // === Training Episodes ===
+    int stepPoints = 0;                       // Points scored during the last stepEpisode (the reward)
+    std::vector<std::pair<float, const Entity*>> nearestEnemies; // observe() scratch: squared distance, enemy
+
+    // === Balance Sweeps ===
+    using TunableMember = std::variant<float Game::*, int Game::*, size_t Game::*>;
+    static const std::vector<std::pair<std::string, TunableMember>>& tunables(); // Name -> knob
 
     // === Input Handling ===
-    void handleInput();                        // Handles player input
-    void fireBullet(bool isSupermove = false); // Fires a bullet (optional supermove mode)
-    void activateSupermove();                  // Fires bullets in all directions
+    void handleInput(InputSampler::Clock::time_point stepStart,
+                     InputSampler::Clock::time_point stepEnd); // Handles window events and the input sampled during the step
+    static Vec2<float> moveDirection(uint8_t moveKeys); // Direction of a set of held MoveKey bits
+    Vec2<float> windowToWorld(int x, int y);    // Maps a mouse position in window pixels into the game world
+    PlayerInput sampleLocalInput();            // Reads keyboard/mouse into one tick of input
+    void applyInput(CInput& input, const PlayerInput& sample); // Copies a sampled input onto a player
+    void updatePlayerActions(float dt);        // Fires bullets and supermoves requested through CInput
+    Vec2<float> playerPositionAt(const std::shared_ptr<Entity>& player, float elapsed); // Player position this far into the update
+    void fireBullet(const std::shared_ptr<Entity>& player, float dt, bool isSupermove = false); // Fires a bullet toward the player's aim
+    void activateSupermove(const std::shared_ptr<Entity>& player, float dt); // Fires bullets in all directions
+
+    // === Network Session ===
+    void updateNetwork(float dt);              // Runs lockstep ticks once every player's input is known
+    std::vector<EntitySnapshot> captureKeyframe(); // Host: quantize (and snap) the world
+    void applyKeyframe(uint32_t tick);         // Client: snap to the host's keyframe, counting corrections
 
     // === Update Logic ===
     void update(float dt);                    // Updates the game state
     void updateSurvivalPoints(float dt);      // Tracks survival time for scoring
-    void updatePlayerInvincibility(float dt); // Updates invincibility frames for the player
-    void updateBulletCooldown(float dt);      // Manages bullet firing cooldown
-    void updateSupermoveCooldown(float dt);   // Manages supermove cooldown
+    void updateTimers(float dt);              // Advances the timing wheel, handling what expires
+    void handleTimer(const TimerExpired& timer); // Bullet expiry, end of invincibility and spawn protection
     void updateBullets(float dt);             // Updates active bullets
-    void updateFragments(float dt);           // Updates fragment entities
+    void updateFragments(float dt);           // Updates fragment particles
     void updateCollisions();                    // Handles all collisions in the game
+    bool handleContact(CollisionLayer query, CollisionLayer target, size_t i, size_t j); // Response to one contact; false stops the query's remaining contacts
+    void collidePatternBullets(float dt);       // Pattern bullets against enemies (after updateCollisions)
+    void separateColliders(Entity& a, Entity& b); // Pushes two solid colliders apart and bounces them
+    void processEvents();                     // Runs event consumers (scoring, effects, damage)
+    void handlePlayerHit(const PlayerHit& hit); // Applies damage, respawn and invincibility
     void createBullet(
         const Vec2<float>& position, // Starting position of the bullet
         const Vec2<float>& velocity,
@@ -52,52 +160,106 @@ private:
     void initializeGameOverText(); // Prepares the "Game Over" text
 
     // === Spawning ===
-    void spawnEnemies(float dt);   // Spawns enemy entities
+    std::shared_ptr<Entity> spawnEnemy(const Vec2<float>& position, const Vec2<float>& velocity, int sides); // One enemy with spawn protection
+    void spawnRandomEnemy();       // Random position, direction and shape
+    void spawnRing(int count, int sides, float radius); // Enemies on a circle around the player, closing in
+    SpawnPlacer& spawnPlacement();  // The placer, indexed once per update with the current enemies and players
+    SpawnPlacer spawnPlacer;        // Poisson-disk spawn points clear of enemies and players
+    uint64_t spawnPlacerTick = ~uint64_t{0}; // EntityManager tick spawnPlacer was indexed at (all ones = never)
+
+    // === Wave Scripts ===
+    // Designers write waves as coroutines that co_await scripts.wait/until/next
+    void startWaveScripts();       // (Re)starts every wave script for a new game
+    ScriptTask enemyStream();      // The steady trickle of random enemies
+    ScriptTask ringWaves();        // Periodic rings of hexagons
 
     // === Explosions ===
-    void explodeEnemy(std::shared_ptr<Entity> enemy); // Handles enemy destruction visuals
+    void explodeEnemy(const EnemyKilled& kill); // Handles enemy destruction visuals
 
     // === Game Logic ===
     void updatePlayer(float dt); // Handles player movement logic
+    void spawnPlayer(int slot);  // Creates the player controlled by the given session slot
+    Vec2<float> playerSpawnPoint(int slot) const; // Where a slot's player starts and respawns
+    std::shared_ptr<Entity> localPlayer();        // The player fed by this machine's keyboard (or null)
+    std::shared_ptr<Entity> playerInSlot(int slot); // The player a session slot controls (or null)
     void processEnemyMovement(float dt);  // Handles enemy movement logic
 
     // === Core Components ===
-    sf::RenderWindow window;        // Main game window
+    std::unique_ptr<sf::RenderWindow> window; // Main game window (null in headless runs and simulation-only instances)
     EntityManager entityManager;    // Manages all entities in the game
+    EventBus events;                // Gameplay events, consumed once per frame in processEvents
+    CommandBuffers commands;        // Deferred create/destroy/add-component, flushed at sync points
+    TimingWheel<TimerExpired> timers; // Lifespans and protection windows (timers.now() is the game time)
+    ScriptScheduler scripts;        // Wave scripts, resumed when their delay, condition or event comes
+    ParticleSystem particles;       // Explosion fragments (SoA ring buffer, not entities)
+    std::vector<sf::Vertex> bulletVertices;   // Visible entity bullets, rebuilt every frame
+    std::vector<sf::Vertex> particleVertices; // Fragment geometry rebuilt every frame
+    BulletPatternSystem bulletPatterns; // Supermove bullets, evaluated from their pattern (not entities)
+    std::vector<sf::Vertex> patternVertices;  // Pattern bullet geometry rebuilt every frame
+    std::vector<sf::Vertex> enemyVertices;    // Enemy outlines, from the cached CPolygon corners
+    CollisionWorld collisionWorld;  // Collision matrix and per-layer broad phase
+    std::vector<uint8_t> enemyClaimed; // Enemies already killed by a bullet this frame (by collider index)
+    std::unique_ptr<LockstepSession> session; // Multiplayer session (null in single player)
+    RandomStream spawnRandom{0, RandomStreamId::Spawns}; // Spawn positions, headings and shapes
+    RandomStream colorRandom{0, RandomStreamId::Colors}; // Enemy and player colors
+    void seedRandom(uint64_t seed, uint32_t substream = 0); // Restarts every stream from one game or session seed
+
+    // === World ===
+    float worldWidth = 1200.0f;     // Playfield size (the window is opened at this size)
+    float worldHeight = 700.0f;
 
     // === Player Attributes ===
     float playerSpeed = 200.0f;         // Movement speed
     float playerRadius = 45.0f;         // Radius for player collision
     float playerRotationSpeed = 360.0f; // Player rotation speed (degrees per second)
-    int playerLives = 3;                // Initial number of lives
+    int playerLives = 3;                // Initial number of lives (per player, tracked in CLives)
     float playerInvincibilityTime = 3.0f;     // Player is invincible after spawing to avoid death on spawn
+    float supermoveCooldownPerSide = 1.0f;    // Supermove cooldown per side of the player's shape (seconds)
 
     // === Enemy Attributes ===
-    float enemySpawnTimer = 0.0f;       // Tracks time for spawning enemies
     float enemySpawnInterval = 0.7f;    // Interval between enemy spawns
     float enemySpeed = 130.0f;          // Enemy movement speed
     float enemyRadius = 35.0f;          // Enemy collision radius
     float enemyRotationSpeed = 360.0f;  // Enemy rotation speed (degrees per second)
     size_t maxEnemyPerFrame = 15;       // Max enemies to spawn per frame
     float spawnProtectionTime = 1.0f; // Duration for spawn protection
+    float ringWaveInterval = 30.0f;   // Time between ring waves
+    int ringWaveSize = 12;            // Enemies per ring
+    float ringWaveRadius = 300.0f;    // Ring radius around the player
+    float enemySpawnSpacing = 90.0f;  // Spawn points keep this far from other enemies' centers
+    float spawnPlayerClearance = 220.0f; // ...and this far from every player's center
 
     // === Bullet Attributes ===
     float superBulletSpeed = 500.0f;    // Fixed super bullet speed
     float bulletSpeed = 2.3f;           // Fixed bullet speed
     float bulletCooldown = 0.1f;       // Time between bullet shots
-    float bulletCooldownTimer = 0.0f;  // Tracks cooldown time
     float bulletLifeTime = 1.0f;       // Lifespan of bullets (seconds)
+    float collisionCellSize = 96.0f;   // Broad-phase grid cell size (a bit over one enemy diameter)
 
     // === Fragment Attributes ===
     float fragmentSpeed = 200.0f;         // Speed of fragments after explosions
     float fragmentLifeTime = 1.0f;      // Lifespan of fragments
 
-    // === Supermove Attributes ===
-    float supermoveCooldown = 4.0f;     // Time between supermove uses
-    float supermoveTimer = 0.0f;        // Tracks supermove cooldown
-    bool supermoveReady = true;         // Indicates if supermove is ready
+    // === Local Input ===
+    InputSampler inputSampler;          // Keyboard/mouse sampled between frames into timestamped events
+    uint8_t heldMoveKeys = 0;           // Movement keys held at the end of the last step (MoveKey bits)
+    bool fireRequested = false;         // Left click since the last input sample
+    bool supermoveRequested = false;    // Space pressed since the last input sample
+    float fireTime = 0.0f;              // Fraction of the step at which fire was pressed
+    float supermoveTime = 0.0f;         // Fraction of the step at which the supermove was pressed
+    Vec2<float> fireAim;                // World position of the mouse at the click
+
+    // === Network Attributes ===
+    float networkTickDt = 1.0f / 60.0f; // Fixed simulation step shared by every peer
+    float maxNetworkCatchUp = 0.25f;    // Longest backlog simulated after a stall (seconds)
+    float networkAccumulator = 0.0f;    // Frame time not yet simulated
+    uint32_t networkTick = 0;           // Next tick to simulate
+    std::function<PlayerInput(uint32_t)> scriptedInput; // Replaces sampleLocalInput when set
+    std::vector<uint64_t> tickChecksums; // Simulation-only peers: state after every tick
+    bool networkPlayersSpawned = false; // Players are created once the session starts
 
     // === HUD Elements ===
+    MappedFile fontMapping;             // Backing memory for a font override (must outlive font)
     sf::Font font;                      // Font used for all HUD text
     sf::Text livesText;                 // Displays the player's remaining lives
     sf::Text bestScoreText;             // Displays the best score for the player's current shape
@@ -116,16 +278,18 @@ private:
     };
 
 // === Utility Function ===
-// Returns a random number in the range [min, max]
+// Returns a random number in [min, max] for integers, [min, max) for floating point
+// (plain arithmetic on the stream rather than std distributions, whose
+// results differ between standard libraries and would desync lockstep peers)
 template <typename T>
-T getRandom(T min, T max) {
+T getRandom(RandomStream& random, T min, T max) {
     static_assert(std::is_arithmetic<T>::value, "Template type must be numeric");
 
     if constexpr (std::is_integral<T>::value) {
-        // For integers
-        return min + (rand() % (max - min + 1));
+        // For integers (unbiased)
+        return min + static_cast<T>(random.below(static_cast<uint32_t>(max - min + 1)));
     } else {
         // For floating-point numbers
-        return min + static_cast<T>(rand()) / (static_cast<T>(RAND_MAX) / (max - min));
+        return min + static_cast<T>(random.uniform()) * (max - min);
     }
 }
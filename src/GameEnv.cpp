@@ -0,0 +1,105 @@
+#include "GameEnv.h"
+#include "Game.h"
+#include "ThreadPool.hpp"
+#include <chrono>
+
+struct GameEnvBatch {
+    std::vector<std::unique_ptr<Game>> games;
+    std::vector<uint32_t> episodes; // Episodes started per game (the high half of the next episode's seed)
+    ThreadPool pool;
+    uint32_t seed;
+    float dt = 1.0f / 60.0f;        // Same fixed step as bot runs and lockstep sessions
+    uint64_t steps = 0;             // Game steps taken by game_env_step
+    double stepSeconds = 0.0;       // Wall-clock time spent in game_env_step
+
+    GameEnvBatch(int count, int threads, uint32_t baseSeed)
+        : episodes(static_cast<size_t>(count), 0), pool(static_cast<size_t>(threads)), seed(baseSeed) {
+        GameOptions options;
+        options.simulationOnly = true;
+        for (int i = 0; i < count; ++i) {
+            games.push_back(std::make_unique<Game>(options));
+        }
+    }
+
+    // Episode e of game k draws from substream k of the key (batch seed, e):
+    // distinct counters, so no two games or episodes can share random numbers,
+    // and a game's numbers do not depend on which worker thread runs it
+    void resetGame(size_t game, float* observation) {
+        games[game]->resetEpisode(seed | uint64_t{episodes[game]} << 32, static_cast<uint32_t>(game));
+        ++episodes[game];
+        games[game]->observe(observation);
+    }
+};
+
+// Maps one game's action floats onto the input a player would send
+static PlayerInput decodeAction(const float* action, const Vec2<float>& worldSize) {
+    PlayerInput input;
+    input.left = action[0] < -0.5f;
+    input.right = action[0] > 0.5f;
+    input.up = action[1] < -0.5f;
+    input.down = action[1] > 0.5f;
+    input.aimX = static_cast<int32_t>(action[2] * worldSize.x);
+    input.aimY = static_cast<int32_t>(action[3] * worldSize.y);
+    input.fire = action[4] > 0.5f;
+    input.supermove = action[5] > 0.5f;
+    return input;
+}
+
+extern "C" {
+
+GameEnvBatch* game_env_create(int count, int threads, uint32_t seed) {
+    if (count <= 0 || threads < 0) {
+        std::cerr << "game_env_create: invalid game or thread count" << std::endl;
+        return nullptr;
+    }
+    return new GameEnvBatch(count, threads, seed);
+}
+
+void game_env_destroy(GameEnvBatch* batch) {
+    delete batch;
+}
+
+int game_env_count(const GameEnvBatch* batch) {
+    return static_cast<int>(batch->games.size());
+}
+
+int game_env_observation_size(void) {
+    return GAME_ENV_OBSERVATION_SIZE;
+}
+
+int game_env_action_size(void) {
+    return GAME_ENV_ACTION_SIZE;
+}
+
+void game_env_reset(GameEnvBatch* batch, float* observations) {
+    batch->pool.parallelFor(batch->games.size(), [&](size_t i) {
+        batch->resetGame(i, observations + i * GAME_ENV_OBSERVATION_SIZE);
+    });
+}
+
+void game_env_step(GameEnvBatch* batch, const float* actions, float* observations, float* rewards, uint8_t* dones) {
+    auto start = std::chrono::steady_clock::now();
+
+    batch->pool.parallelFor(batch->games.size(), [&](size_t i) {
+        Game& game = *batch->games[i];
+        float* observation = observations + i * GAME_ENV_OBSERVATION_SIZE;
+
+        game.stepEpisode(decodeAction(actions + i * GAME_ENV_ACTION_SIZE, game.worldSize()), batch->dt);
+        rewards[i] = static_cast<float>(game.lastStepPoints());
+        dones[i] = game.episodeOver() ? 1 : 0;
+        if (dones[i]) {
+            batch->resetGame(i, observation); // Auto-reset: the observation starts the next episode
+        } else {
+            game.observe(observation);
+        }
+    });
+
+    batch->stepSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    batch->steps += batch->games.size();
+}
+
+double game_env_steps_per_second(const GameEnvBatch* batch) {
+    return batch->stepSeconds > 0.0 ? static_cast<double>(batch->steps) / batch->stepSeconds : 0.0;
+}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+
+// C API for training agents on batches of headless games
+// A batch holds K independent games in one process. Every call to
+// game_env_step advances all of them by one fixed 1/60 s step, spread over a
+// thread pool, with no window or rendering. A game that ends is reset to a
+// new episode inside the same call (its done flag is set and its observation
+// is the first of the new episode). Usable from C, or from Python via ctypes.
+
+#define GAME_ENV_NEAREST_ENEMIES 8  // Enemies described in each observation
+#define GAME_ENV_ENEMY_FEATURES 7   // Floats per enemy
+#define GAME_ENV_OBSERVATION_SIZE (8 + GAME_ENV_NEAREST_ENEMIES * GAME_ENV_ENEMY_FEATURES)
+#define GAME_ENV_ACTION_SIZE 6
+
+// Observation (floats per game):
+//   0  player x / world width        4  supermove ready (0 or 1)
+//   1  player y / world height       5  player invincible (0 or 1)
+//   2  lives left / starting lives   6  points scored in the last step / 100
+//   3  shot ready (0 or 1)           7  enemies alive / 100
+//   then per enemy, nearest first (all zero when there are fewer enemies):
+//   present, dx / world width, dy / world height, vx / enemy speed,
+//   vy / enemy speed, radius / player radius, sides / 8
+//
+// Action (floats per game):
+//   0  move x (-1 left, 1 right; |value| > 0.5 presses the key)
+//   1  move y (-1 up, 1 down)
+//   2  aim x / world width
+//   3  aim y / world height
+//   4  fire (> 0.5)
+//   5  supermove (> 0.5)
+//
+// Reward: points scored during the step (survival and kills).
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct GameEnvBatch GameEnvBatch;
+
+// count games stepped on threads threads (0 = one per hardware thread);
+// episodes are seeded from seed, so a batch replays exactly for a given seed
+GameEnvBatch* game_env_create(int count, int threads, uint32_t seed);
+void game_env_destroy(GameEnvBatch* batch);
+
+int game_env_count(const GameEnvBatch* batch);
+int game_env_observation_size(void);
+int game_env_action_size(void);
+
+// Starts a new episode in every game; observations holds count * observation size floats
+void game_env_reset(GameEnvBatch* batch, float* observations);
+
+// actions: count * action size floats; observations: count * observation size;
+// rewards: count floats; dones: count bytes (1 when the game ended this step)
+void game_env_step(GameEnvBatch* batch, const float* actions, float* observations, float* rewards, uint8_t* dones);
+
+// Game steps per wall-clock second across the whole batch, over every game_env_step so far
+double game_env_steps_per_second(const GameEnvBatch* batch);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// Command line options for the game executable
+struct GameOptions {
+    bool startupProfile = false; // Print the startup timeline after the first frame
+    std::string fontPath;        // Font file to map instead of the embedded one
+    uint16_t hostPort = 0;       // Host a multiplayer session on this UDP port
+    int players = 2;             // Players in a hosted session (including the host)
+    std::string joinAddress;     // Join the session at "host:port"
+    std::string latencyReport;   // Write frame latency percentiles here on exit (and on SIGUSR1)
+    std::string latencyBudget;   // Fail the run when a percentile exceeds its limit, e.g. "frame:p99=20"
+    bool bot = false;            // A bot plays instead of the keyboard and mouse
+    uint32_t botSeed = 1;        // Seed for the bot's decisions
+    bool headless = false;       // No window: no rendering, input or HUD
+    int timeScale = 1;           // Simulation steps per frame in bot runs
+    float botDuration = 0.0f;    // Stop a bot run after this many simulated seconds (0 = never)
+    std::string soakLog;         // Per-second CSV of entity counts, collision pairs and step cost
+    std::string telemetryPath;   // Record entity transforms and shapes to this file (see Telemetry.hpp)
+    uint32_t telemetryInterval = 6; // Updates between telemetry samples
+    uint32_t spatialSortInterval = 8; // Updates between Z-order sorts of one entity group (0 = never)
+    double frameBudgetMs = 1000.0 / 60.0; // Work per frame the quality governor holds to (0 = full quality always)
+    bool simulationOnly = false; // No window, input or HUD, driven step by step (set by GameEnv, not the command line)
+};
+
+// Parses argv into GameOptions; unknown flags are reported and ignored
+inline GameOptions parseGameOptions(int argc, char* argv[]) {
+    GameOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--startup-profile") {
+            options.startupProfile = true;
+        } else if (arg == "--font" && i + 1 < argc) {
+            options.fontPath = argv[++i];
+        } else if (arg == "--host" && i + 1 < argc) {
+            options.hostPort = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (arg == "--players" && i + 1 < argc) {
+            options.players = std::max(1, std::min(std::atoi(argv[++i]), 8));
+        } else if (arg == "--join" && i + 1 < argc) {
+            options.joinAddress = argv[++i];
+        } else if (arg == "--latency-report" && i + 1 < argc) {
+            options.latencyReport = argv[++i];
+        } else if (arg == "--latency-budget" && i + 1 < argc) {
+            options.latencyBudget = argv[++i];
+        } else if (arg == "--bot") {
+            options.bot = true;
+        } else if (arg == "--bot-seed" && i + 1 < argc) {
+            options.botSeed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--headless") {
+            options.headless = true;
+        } else if (arg == "--time-scale" && i + 1 < argc) {
+            options.timeScale = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--duration" && i + 1 < argc) {
+            options.botDuration = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--soak-log" && i + 1 < argc) {
+            options.soakLog = argv[++i];
+        } else if (arg == "--telemetry" && i + 1 < argc) {
+            options.telemetryPath = argv[++i];
+        } else if (arg == "--spatial-sort" && i + 1 < argc) {
+            options.spatialSortInterval = static_cast<uint32_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--frame-budget" && i + 1 < argc) {
+            options.frameBudgetMs = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--telemetry-interval" && i + 1 < argc) {
+            options.telemetryInterval = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+        }
+    }
+    return options;
+}
@@ -0,0 +1,66 @@
+#include "InputSampler.hpp"
+#include <SFML/Window.hpp>
+#include <algorithm>
+#include <thread>
+
+void InputSampler::sample(const sf::Window& window) {
+    auto now = Clock::now();
+
+    // Movement keys (WASD); losing focus releases them all so none stick
+    uint8_t keys = 0;
+    if (m_focused) {
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::W)) keys |= MoveUp;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::S)) keys |= MoveDown;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::A)) keys |= MoveLeft;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::D)) keys |= MoveRight;
+    }
+    if (keys != m_heldKeys) {
+        m_heldKeys = keys;
+        emit(InputEvent::Move, window, now);
+    }
+
+    // Actions fire on the press edge only
+    bool fire = m_focused && sf::Mouse::isButtonPressed(sf::Mouse::Left);
+    if (fire && !m_firePressed) {
+        emit(InputEvent::Fire, window, now);
+    }
+    m_firePressed = fire;
+
+    bool supermove = m_focused && sf::Keyboard::isKeyPressed(sf::Keyboard::Space);
+    if (supermove && !m_supermovePressed) {
+        emit(InputEvent::Supermove, window, now);
+    }
+    m_supermovePressed = supermove;
+}
+
+void InputSampler::sampleUntil(const sf::Window& window, Clock::time_point deadline) {
+    sample(window);
+    // Keep a steady cadence, sleeping no further than the deadline
+    for (auto next = Clock::now() + samplePeriod; next < deadline; next += samplePeriod) {
+        std::this_thread::sleep_until(next);
+        sample(window);
+    }
+    std::this_thread::sleep_until(deadline);
+}
+
+bool InputSampler::poll(InputEvent& out, Clock::time_point until) {
+    if (m_queue.empty() || m_queue.front().time > until) {
+        return false;
+    }
+    out = m_queue.front();
+    m_queue.pop_front();
+    return true;
+}
+
+void InputSampler::emit(InputEvent::Type type, const sf::Window& window, Clock::time_point time) {
+    InputEvent event;
+    event.type = type;
+    event.moveKeys = m_heldKeys;
+    event.time = time;
+    if (type == InputEvent::Fire) {
+        sf::Vector2i mouse = sf::Mouse::getPosition(window);
+        event.mouseX = mouse.x;
+        event.mouseY = mouse.y;
+    }
+    m_queue.push_back(event);
+}
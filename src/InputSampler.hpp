@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+namespace sf {
+class Window;
+}
+
+// Movement keys held, as bits of InputEvent::moveKeys
+enum MoveKey : uint8_t {
+    MoveUp = 1 << 0,
+    MoveDown = 1 << 1,
+    MoveLeft = 1 << 2,
+    MoveRight = 1 << 3
+};
+
+// One timestamped change in the local player's input
+struct InputEvent {
+    enum Type : uint8_t {
+        Move,     // The set of held movement keys changed
+        Fire,     // Left mouse button pressed
+        Supermove // Space pressed
+    };
+
+    Type type = Move;
+    uint8_t moveKeys = 0;           // Movement keys held after this event (MoveKey bits)
+    int32_t mouseX = 0, mouseY = 0; // Mouse position in window pixels when sampled
+    std::chrono::steady_clock::time_point time;
+};
+
+// Samples keyboard and mouse state and queues the edges with timestamps
+// SFML only supports reading input on the thread that owns the window (macOS
+// enforces it), so sampling happens on the main thread: the game loop calls
+// sampleUntil() for the rest of each frame instead of sleeping in display(),
+// reading input every samplePeriod. The simulation still sees when within a
+// frame each press happened. Window events (closing, focus) are polled by the
+// game as before.
+class InputSampler {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr auto samplePeriod = std::chrono::milliseconds(1);
+
+    // Presses are ignored while the window is not focused
+    void setFocused(bool focused) { m_focused = focused; }
+
+    // Reads input once and queues any edges, stamped now
+    void sample(const sf::Window& window);
+
+    // Samples every samplePeriod until deadline (at least once): the frame limit wait
+    void sampleUntil(const sf::Window& window, Clock::time_point deadline);
+
+    // Take the oldest event stamped at or before until
+    bool poll(InputEvent& out, Clock::time_point until);
+
+private:
+    void emit(InputEvent::Type type, const sf::Window& window, Clock::time_point time);
+
+    std::deque<InputEvent> m_queue;
+    uint8_t m_heldKeys = 0;           // Movement keys held at the last sample
+    bool m_firePressed = false;       // Left button held at the last sample
+    bool m_supermovePressed = false;  // Space held at the last sample
+    bool m_focused = true;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+// Fixed-size log-linear histogram of durations in microseconds (HDR style)
+// Each power-of-two range is split into subBuckets linear buckets, so every
+// recorded value keeps about 1% relative precision from 1 us up to maxValue
+// in constant memory, however long the run.
+class LatencyHistogram {
+public:
+    static constexpr int subBucketBits = 7;
+    static constexpr uint64_t subBuckets = 1ull << subBucketBits;  // 128 buckets per doubling (< 1% error)
+    static constexpr int maxValueBits = 36;                         // Values above ~19 hours are clamped
+    static constexpr uint64_t maxValue = (1ull << maxValueBits) - 1;
+    static constexpr size_t bucketCount = (maxValueBits - subBucketBits + 1) * subBuckets;
+
+    void record(uint64_t micros) {
+        micros = std::min(micros, maxValue);
+        ++m_counts[bucketIndex(micros)];
+        ++m_total;
+        m_sum += micros;
+        m_max = std::max(m_max, micros);
+    }
+
+    // Smallest value that at least percentile% of samples are at or below
+    // (reported as the top of its bucket, never above the true maximum)
+    uint64_t percentile(double percentile) const {
+        if (m_total == 0) {
+            return 0;
+        }
+        uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(m_total)));
+        target = std::clamp<uint64_t>(target, 1, m_total);
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < bucketCount; ++i) {
+            seen += m_counts[i];
+            if (seen >= target) {
+                return std::min(bucketUpper(i), m_max);
+            }
+        }
+        return m_max;
+    }
+
+    uint64_t count() const { return m_total; }
+    uint64_t max() const { return m_max; }
+    double mean() const { return m_total ? static_cast<double>(m_sum) / static_cast<double>(m_total) : 0.0; }
+
+    void reset() {
+        m_counts.fill(0);
+        m_total = 0;
+        m_sum = 0;
+        m_max = 0;
+    }
+
+private:
+    // Values below 2 * subBuckets map one to one; above that, each doubling
+    // gets subBuckets buckets that are 2^shift wide
+    static size_t bucketIndex(uint64_t value) {
+        if (value < 2 * subBuckets) {
+            return static_cast<size_t>(value);
+        }
+        int shift = static_cast<int>(std::bit_width(value)) - (subBucketBits + 1);
+        return static_cast<size_t>((shift + 1) * subBuckets + (value >> shift) - subBuckets);
+    }
+
+    static uint64_t bucketUpper(size_t index) {
+        if (index < 2 * subBuckets) {
+            return index;
+        }
+        int shift = static_cast<int>(index / subBuckets) - 1;
+        uint64_t lower = (index % subBuckets + subBuckets) << shift;
+        return lower + (1ull << shift) - 1;
+    }
+
+    std::array<uint64_t, bucketCount> m_counts{};
+    uint64_t m_total = 0;
+    uint64_t m_sum = 0;
+    uint64_t m_max = 0;
+};
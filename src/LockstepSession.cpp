@@ -0,0 +1,599 @@
+#include "LockstepSession.hpp"
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+
+// Input flag bits on the wire
+enum InputFlags : uint8_t {
+    FlagUp = 1 << 0,
+    FlagDown = 1 << 1,
+    FlagLeft = 1 << 2,
+    FlagRight = 1 << 3,
+    FlagFire = 1 << 4,
+    FlagSupermove = 1 << 5,
+    FlagSameAim = 1 << 6 // Aim unchanged from the previous input in the packet
+};
+
+constexpr size_t maxPacketSize = 1400; // Stay under a typical MTU
+constexpr uint32_t maxKeyframeEntities = 100000; // Larger keyframe headers are refused as corrupt
+
+// Index of the first snapshot with an id of at least id (the list is sorted by id)
+size_t lowerBoundId(const std::vector<EntitySnapshot>& list, uint32_t id) {
+    auto it = std::lower_bound(list.begin(), list.end(), id,
+                               [](const EntitySnapshot& snapshot, uint32_t value) { return snapshot.id < value; });
+    return static_cast<size_t>(it - list.begin());
+}
+
+} // namespace
+
+bool LockstepSession::host(uint16_t port, int players) {
+    m_isHost = true;
+    m_players = std::clamp(players, 1, 32);
+    m_localSlot = 0;
+    if (!m_socket.open(port)) {
+        return false;
+    }
+    if (m_players == 1) {
+        m_seed = static_cast<uint32_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        startSimulation();
+    }
+    return true;
+}
+
+bool LockstepSession::join(const std::string& address) {
+    m_isHost = false;
+    return NetAddress::parse(address, m_hostAddress) && m_socket.open(0);
+}
+
+void LockstepSession::startSimulation() {
+    // Nobody can have input for the first inputDelay ticks: they start empty
+    for (uint32_t tick = 0; tick < inputDelay; ++tick) {
+        auto& entry = tickInputs(tick);
+        entry.receivedMask = (m_players >= 32) ? 0xFFFFFFFF : ((1u << m_players) - 1);
+    }
+    m_completeUpTo = inputDelay;
+    for (auto& peer : m_peers) {
+        peer.inputsUpTo = inputDelay;
+        peer.combinedAcked = inputDelay;
+    }
+    m_started = true;
+}
+
+LockstepSession::TickInputs& LockstepSession::tickInputs(uint32_t tick) {
+    auto& entry = m_ticks[tick];
+    if (entry.inputs.empty()) {
+        entry.inputs.resize(m_players);
+    }
+    return entry;
+}
+
+uint16_t LockstepSession::nowMs() const {
+    auto elapsed = std::chrono::steady_clock::now() - m_epoch;
+    return static_cast<uint16_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+// === Inputs ===
+
+void LockstepSession::submitLocalInput(uint32_t tick, const PlayerInput& input) {
+    if (m_isHost) {
+        auto& entry = tickInputs(tick);
+        entry.inputs[m_localSlot] = input;
+        entry.receivedMask |= 1u << m_localSlot;
+        advanceComplete();
+    } else {
+        m_localPending[tick] = input;
+        m_localUpTo = std::max(m_localUpTo, tick + 1);
+    }
+}
+
+bool LockstepSession::hasLocalInput(uint32_t tick) const {
+    if (tick < inputDelay) {
+        return true;
+    }
+    if (!m_isHost) {
+        return tick < m_localUpTo;
+    }
+    auto it = m_ticks.find(tick);
+    return it != m_ticks.end() && (it->second.receivedMask & (1u << m_localSlot));
+}
+
+bool LockstepSession::readyToStep(uint32_t tick) {
+    if (tick >= m_completeUpTo) {
+        return false;
+    }
+    if (m_isHost || tick == 0 || (tick - 1) % keyframeInterval != 0 || m_receivedKeyframes.count(tick - 1)) {
+        return true;
+    }
+
+    // Keyframe not here yet: wait a little, then carry on if it was lost
+    auto now = std::chrono::steady_clock::now();
+    if (m_keyframeWaitTick != tick) {
+        m_keyframeWaitTick = tick;
+        m_keyframeWaitStart = now;
+    }
+    return now - m_keyframeWaitStart > std::chrono::milliseconds(100);
+}
+
+void LockstepSession::advanceComplete() {
+    uint32_t all = (m_players >= 32) ? 0xFFFFFFFF : ((1u << m_players) - 1);
+    while (true) {
+        auto it = m_ticks.find(m_completeUpTo);
+        if (it == m_ticks.end() || it->second.receivedMask != all) {
+            break;
+        }
+        ++m_completeUpTo;
+    }
+}
+
+void LockstepSession::endTick(uint32_t tick) {
+    ++m_stats.ticks;
+
+    // The host keeps ticks until every client has acknowledged them (for resends)
+    uint32_t keepFrom = tick;
+    for (const auto& peer : m_peers) {
+        keepFrom = std::min(keepFrom, peer.combinedAcked);
+    }
+    m_ticks.erase(m_ticks.begin(), m_ticks.lower_bound(keepFrom));
+}
+
+// === Packets ===
+
+void LockstepSession::writeHeader(ByteWriter& packet, PacketType type, uint16_t echo) const {
+    packet.u8(type);
+    packet.u16(nowMs());
+    packet.u16(echo);
+}
+
+void LockstepSession::sendPacket(const NetAddress& to, const ByteWriter& packet, bool keyframe) {
+    if (m_socket.send(to, packet.bytes().data(), packet.size())) {
+        m_stats.bytesSent += packet.size();
+        ++m_stats.packetsSent;
+        if (keyframe) {
+            m_stats.keyframeBytes += packet.size();
+        }
+    }
+}
+
+void LockstepSession::sampleRtt(uint16_t echo) {
+    if (echo == 0) {
+        return; // Peer has not heard from us yet
+    }
+    double rtt = static_cast<uint16_t>(nowMs() - echo); // Wraps every 65 s, fine for RTT
+    m_stats.rttMinMs = m_stats.rttSamples == 0 ? rtt : std::min(m_stats.rttMinMs, rtt);
+    m_stats.rttMaxMs = std::max(m_stats.rttMaxMs, rtt);
+    m_stats.rttSumMs += rtt;
+    ++m_stats.rttSamples;
+}
+
+void LockstepSession::writeInput(ByteWriter& packet, const PlayerInput& input, const PlayerInput& previous) {
+    bool sameAim = input.aimX == previous.aimX && input.aimY == previous.aimY;
+    uint8_t flags = (input.up ? FlagUp : 0) | (input.down ? FlagDown : 0)
+                  | (input.left ? FlagLeft : 0) | (input.right ? FlagRight : 0)
+                  | (input.fire ? FlagFire : 0) | (input.supermove ? FlagSupermove : 0)
+                  | (sameAim ? FlagSameAim : 0);
+    packet.u8(flags);
+    if (!sameAim) {
+        packet.svarint(input.aimX - previous.aimX);
+        packet.svarint(input.aimY - previous.aimY);
+    }
+}
+
+PlayerInput LockstepSession::readInput(ByteReader& reader, const PlayerInput& previous) {
+    uint8_t flags = reader.u8();
+    PlayerInput input;
+    input.up = flags & FlagUp;
+    input.down = flags & FlagDown;
+    input.left = flags & FlagLeft;
+    input.right = flags & FlagRight;
+    input.fire = flags & FlagFire;
+    input.supermove = flags & FlagSupermove;
+    input.aimX = previous.aimX;
+    input.aimY = previous.aimY;
+    if (!(flags & FlagSameAim)) {
+        input.aimX += reader.svarint();
+        input.aimY += reader.svarint();
+    }
+    return input;
+}
+
+void LockstepSession::service() {
+    receive();
+
+    if (m_isHost) {
+        for (auto& peer : m_peers) {
+            ByteWriter packet;
+            if (!peer.confirmed) {
+                if (!m_started) {
+                    continue; // Start goes out once every slot is taken
+                }
+                writeHeader(packet, Start, peer.echoTime);
+                packet.u32(m_seed);
+                packet.u8(static_cast<uint8_t>(m_players));
+                packet.u8(static_cast<uint8_t>(peer.slot));
+                sendPacket(peer.address, packet);
+                continue;
+            }
+
+            // Every complete tick this peer has not acknowledged yet
+            writeHeader(packet, Inputs, peer.echoTime);
+            uint32_t first = peer.combinedAcked;
+            uint32_t count = std::min(m_completeUpTo - std::min(first, m_completeUpTo), maxInputWindow);
+            packet.varint(peer.inputsUpTo);
+            packet.varint(first);
+            packet.varint(count);
+            std::vector<PlayerInput> previous(m_players);
+            for (uint32_t tick = first; tick < first + count; ++tick) {
+                const auto& inputs = m_ticks.at(tick).inputs;
+                for (int slot = 0; slot < m_players; ++slot) {
+                    writeInput(packet, inputs[slot], previous[slot]);
+                    previous[slot] = inputs[slot];
+                }
+            }
+            sendPacket(peer.address, packet);
+        }
+        return;
+    }
+
+    // Client
+    ByteWriter packet;
+    if (!m_started) {
+        auto now = std::chrono::steady_clock::now();
+        if (now - m_lastJoin > std::chrono::milliseconds(100)) {
+            m_lastJoin = now;
+            writeHeader(packet, Join, m_hostEcho);
+            sendPacket(m_hostAddress, packet);
+        }
+        return;
+    }
+
+    writeHeader(packet, Input, m_hostEcho);
+    packet.varint(m_keyframeAck == noTick ? 0 : m_keyframeAck + 1);
+    packet.varint(m_completeUpTo);
+    uint32_t first = m_localPending.empty() ? 0 : m_localPending.begin()->first;
+    uint32_t count = 0;
+    for (auto it = m_localPending.begin(); it != m_localPending.end() && count < maxInputWindow; ++it, ++count) {
+        if (it->first != first + count) {
+            break; // Only a contiguous run of ticks
+        }
+    }
+    packet.varint(first);
+    packet.varint(count);
+    PlayerInput previous;
+    auto it = m_localPending.begin();
+    for (uint32_t i = 0; i < count; ++i, ++it) {
+        writeInput(packet, it->second, previous);
+        previous = it->second;
+    }
+    sendPacket(m_hostAddress, packet);
+}
+
+void LockstepSession::receive() {
+    uint8_t buffer[maxPacketSize * 4];
+    NetAddress from;
+    bool truncated = false;
+    while (size_t size = m_socket.receive(buffer, sizeof(buffer), from, truncated)) {
+        m_stats.bytesReceived += size;
+        ++m_stats.packetsReceived;
+        if (truncated) {
+            ++m_stats.truncatedPackets; // Its tail is gone: parsing the rest would misread it
+            continue;
+        }
+
+        ByteReader reader(buffer, size);
+        uint8_t type = reader.u8();
+        uint16_t sentAt = reader.u16();
+        uint16_t echo = reader.u16();
+        if (reader.failed()) {
+            continue;
+        }
+
+        if (m_isHost) {
+            auto peer = std::find_if(m_peers.begin(), m_peers.end(), [&](const Peer& p) { return p.address == from; });
+            if (peer != m_peers.end()) {
+                peer->echoTime = sentAt;
+            }
+        } else {
+            m_hostEcho = sentAt;
+        }
+        handlePacket(from, reader, type, echo);
+    }
+}
+
+void LockstepSession::handlePacket(const NetAddress& from, ByteReader& reader, uint8_t type, uint16_t echo) {
+    if (m_isHost) {
+        auto peer = std::find_if(m_peers.begin(), m_peers.end(), [&](const Peer& p) { return p.address == from; });
+
+        if (type == Join) {
+            if (peer == m_peers.end() && !m_started && static_cast<int>(m_peers.size()) < m_players - 1) {
+                Peer joined;
+                joined.address = from;
+                joined.slot = static_cast<int>(m_peers.size()) + 1;
+                m_peers.push_back(joined);
+                if (static_cast<int>(m_peers.size()) == m_players - 1) {
+                    m_seed = static_cast<uint32_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+                    startSimulation();
+                }
+            }
+            return;
+        }
+
+        if (type != Input || peer == m_peers.end()) {
+            return;
+        }
+        peer->confirmed = true;
+        sampleRtt(echo);
+
+        uint32_t keyframeAck = reader.varint();
+        uint32_t combinedAck = reader.varint();
+        uint32_t first = reader.varint();
+        uint32_t count = std::min(reader.varint(), maxInputWindow);
+        if (reader.failed()) {
+            return;
+        }
+        if (keyframeAck != 0 && (peer->keyframeAck == noTick || keyframeAck - 1 > peer->keyframeAck)) {
+            peer->keyframeAck = keyframeAck - 1;
+        }
+        peer->combinedAcked = std::max(peer->combinedAcked, std::min(combinedAck, m_completeUpTo));
+
+        PlayerInput previous;
+        for (uint32_t tick = first; tick < first + count; ++tick) {
+            PlayerInput input = readInput(reader, previous);
+            previous = input;
+            if (reader.failed()) {
+                return;
+            }
+            if (tick < m_completeUpTo) {
+                continue; // Already have it
+            }
+            auto& entry = tickInputs(tick);
+            if (!(entry.receivedMask & (1u << peer->slot))) {
+                entry.inputs[peer->slot] = input;
+                entry.receivedMask |= 1u << peer->slot;
+            }
+        }
+        while (true) {
+            auto it = m_ticks.find(peer->inputsUpTo);
+            if (it == m_ticks.end() || !(it->second.receivedMask & (1u << peer->slot))) {
+                break;
+            }
+            ++peer->inputsUpTo;
+        }
+        advanceComplete();
+        return;
+    }
+
+    // Client
+    if (!(from == m_hostAddress)) {
+        return;
+    }
+
+    if (type == Start) {
+        uint32_t seed = reader.u32();
+        int players = reader.u8();
+        int slot = reader.u8();
+        if (!reader.failed() && !m_started) {
+            m_seed = seed;
+            m_players = players;
+            m_localSlot = slot;
+            startSimulation();
+        }
+        return;
+    }
+
+    if (type == Inputs) {
+        sampleRtt(echo);
+        uint32_t localAck = reader.varint();
+        uint32_t first = reader.varint();
+        uint32_t count = std::min(reader.varint(), maxInputWindow);
+        if (reader.failed()) {
+            return;
+        }
+        m_localPending.erase(m_localPending.begin(), m_localPending.lower_bound(localAck));
+
+        std::vector<PlayerInput> previous(m_players);
+        for (uint32_t tick = first; tick < first + count; ++tick) {
+            std::vector<PlayerInput> inputs(m_players);
+            for (int slot = 0; slot < m_players; ++slot) {
+                inputs[slot] = readInput(reader, previous[slot]);
+                previous[slot] = inputs[slot];
+            }
+            if (reader.failed()) {
+                return;
+            }
+            if (tick >= m_completeUpTo) {
+                auto& entry = tickInputs(tick);
+                entry.inputs = std::move(inputs);
+                entry.receivedMask = (m_players >= 32) ? 0xFFFFFFFF : ((1u << m_players) - 1);
+            }
+        }
+        advanceComplete();
+        return;
+    }
+
+    if (type == Keyframe) {
+        uint32_t tick = reader.varint();
+        uint32_t base = reader.varint();
+        uint32_t total = reader.varint();
+        uint32_t first = reader.varint();
+        if (reader.failed() || total > maxKeyframeEntities || m_receivedKeyframes.count(tick)) {
+            return;
+        }
+        const std::vector<EntitySnapshot>* baseline = nullptr;
+        if (base != 0) {
+            auto it = m_receivedKeyframes.find(base - 1);
+            if (it == m_receivedKeyframes.end()) {
+                return; // Baseline no longer held; the next keyframe will use a newer one
+            }
+            baseline = &it->second;
+        }
+        std::vector<EntitySnapshot> chunk;
+        if (!readKeyframe(reader, chunk, baseline) || first > total || chunk.size() > total - first ||
+            (chunk.empty() && total != 0)) {
+            return;
+        }
+
+        // Fill this chunk's run of entities in; the keyframe counts once all of them are here
+        auto [entry, added] = m_partialKeyframes.try_emplace(tick);
+        PartialKeyframe& partial = entry->second;
+        if (added) {
+            partial.base = base;
+            partial.world.resize(total);
+        } else if (partial.base != base || partial.world.size() != total) {
+            return; // Not part of the keyframe begun under this tick
+        }
+        if (!partial.chunks.insert(first).second) {
+            return; // Duplicate datagram
+        }
+        std::copy(chunk.begin(), chunk.end(), partial.world.begin() + first);
+        partial.received += chunk.size();
+        if (partial.received < total) {
+            return;
+        }
+
+        ++m_stats.keyframesReceived;
+        m_receivedKeyframes[tick] = std::move(partial.world);
+        if (m_keyframeAck == noTick || tick > m_keyframeAck) {
+            m_keyframeAck = tick;
+        }
+        // Chunks of this or older keyframes that are still missing pieces will not complete in time
+        m_partialKeyframes.erase(m_partialKeyframes.begin(), m_partialKeyframes.upper_bound(tick));
+        // Keep a few recent keyframes as possible baselines
+        while (m_receivedKeyframes.size() > 8) {
+            m_receivedKeyframes.erase(m_receivedKeyframes.begin());
+        }
+        while (m_partialKeyframes.size() > 8) { // Unfinished ones only linger if their chunks were lost
+            m_partialKeyframes.erase(m_partialKeyframes.begin());
+        }
+    }
+}
+
+// === Keyframes ===
+
+size_t LockstepSession::writeKeyframe(ByteWriter& packet, const std::vector<EntitySnapshot>& world, size_t first,
+                                      const std::vector<EntitySnapshot>* baseline) {
+    // Ids are delta coded from 0 again in every chunk, so each decodes on its own
+    uint32_t previousId = 0;
+    size_t b = (baseline && first < world.size()) ? lowerBoundId(*baseline, world[first].id) : 0;
+    ByteWriter entry;
+    size_t i = first;
+    for (; i < world.size(); ++i) {
+        const auto& entity = world[i];
+        // Both lists are sorted by id: walk the baseline alongside
+        while (baseline && b < baseline->size() && (*baseline)[b].id < entity.id) {
+            ++b;
+        }
+        bool hasBase = baseline && b < baseline->size() && (*baseline)[b].id == entity.id;
+        EntitySnapshot reference = hasBase ? (*baseline)[b] : EntitySnapshot{entity.id, 0, 0, 0, 0};
+
+        entry.clear();
+        entry.varint(((entity.id - previousId) << 1) | (hasBase ? 1 : 0));
+        entry.svarint(entity.x - reference.x);
+        entry.svarint(entity.y - reference.y);
+        entry.svarint(entity.vx - reference.vx);
+        entry.svarint(entity.vy - reference.vy);
+        if (packet.size() + entry.size() > maxPacketSize) {
+            break; // The rest goes in the next chunk
+        }
+        packet.append(entry);
+        previousId = entity.id;
+    }
+    return i;
+}
+
+bool LockstepSession::readKeyframe(ByteReader& reader, std::vector<EntitySnapshot>& world,
+                                   const std::vector<EntitySnapshot>* baseline) {
+    uint32_t previousId = 0;
+    size_t b = 0;
+    while (reader.remaining() > 0 && !reader.failed()) {
+        uint32_t header = reader.varint();
+        EntitySnapshot entity{previousId + (header >> 1), 0, 0, 0, 0};
+        if (world.empty() && baseline) {
+            b = lowerBoundId(*baseline, entity.id); // The chunk's run starts partway through the baseline
+        }
+        if (header & 1) {
+            while (baseline && b < baseline->size() && (*baseline)[b].id < entity.id) {
+                ++b;
+            }
+            if (!baseline || b >= baseline->size() || (*baseline)[b].id != entity.id) {
+                return false;
+            }
+            entity = (*baseline)[b];
+        }
+        entity.x += reader.svarint();
+        entity.y += reader.svarint();
+        entity.vx += reader.svarint();
+        entity.vy += reader.svarint();
+        world.push_back(entity);
+        previousId = entity.id;
+    }
+    return !reader.failed();
+}
+
+void LockstepSession::sendKeyframe(uint32_t tick, std::vector<EntitySnapshot> world) {
+    std::sort(world.begin(), world.end(), [](const auto& a, const auto& b) { return a.id < b.id; });
+
+    for (auto& peer : m_peers) {
+        if (!peer.confirmed) {
+            continue;
+        }
+        auto base = m_sentKeyframes.find(peer.keyframeAck);
+        const std::vector<EntitySnapshot>* baseline = base != m_sentKeyframes.end() ? &base->second : nullptr;
+
+        // One datagram per run of entities that fits maxPacketSize, each saying
+        // which keyframe it belongs to and where its run starts
+        size_t first = 0;
+        do {
+            ByteWriter packet;
+            writeHeader(packet, Keyframe, peer.echoTime);
+            packet.varint(tick);
+            packet.varint(baseline ? peer.keyframeAck + 1 : 0);
+            packet.varint(static_cast<uint32_t>(world.size()));
+            packet.varint(static_cast<uint32_t>(first));
+            first = writeKeyframe(packet, world, first, baseline);
+            sendPacket(peer.address, packet, true);
+        } while (first < world.size());
+        ++m_stats.keyframesSent;
+    }
+
+    // Keep keyframes that a client may still use as a baseline
+    m_sentKeyframes[tick] = std::move(world);
+    uint32_t oldestAck = tick;
+    for (const auto& peer : m_peers) {
+        if (peer.keyframeAck != noTick) {
+            oldestAck = std::min(oldestAck, peer.keyframeAck);
+        }
+    }
+    m_sentKeyframes.erase(m_sentKeyframes.begin(), m_sentKeyframes.lower_bound(oldestAck));
+}
+
+bool LockstepSession::takeKeyframe(uint32_t tick, std::vector<EntitySnapshot>& out) const {
+    auto it = m_receivedKeyframes.find(tick);
+    if (it == m_receivedKeyframes.end()) {
+        return false;
+    }
+    out = it->second;
+    return true;
+}
+
+void LockstepSession::printStats(std::ostream& out) const {
+    double ticks = std::max<uint32_t>(m_stats.ticks, 1);
+    out << std::fixed << std::setprecision(1)
+        << "Network session (" << (m_isHost ? "host" : "client") << ", slot " << m_localSlot
+        << " of " << m_players << ", " << m_stats.ticks << " ticks)\n"
+        << "  sent:       " << m_stats.bytesSent << " bytes in " << m_stats.packetsSent << " packets ("
+        << m_stats.bytesSent / ticks << " bytes/tick)\n"
+        << "  received:   " << m_stats.bytesReceived << " bytes in " << m_stats.packetsReceived << " packets ("
+        << m_stats.bytesReceived / ticks << " bytes/tick)\n"
+        << "  keyframes:  " << m_stats.keyframesSent << " sent (" << m_stats.keyframeBytes << " bytes), "
+        << m_stats.keyframesReceived << " received, " << m_stats.corrections << " corrections\n"
+        << "  truncated:  " << m_stats.truncatedPackets << " packets dropped\n"
+        << "  rtt:        ";
+    if (m_stats.rttSamples > 0) {
+        out << "avg " << m_stats.rttSumMs / m_stats.rttSamples << " ms, min " << m_stats.rttMinMs
+            << " ms, max " << m_stats.rttMaxMs << " ms\n";
+    } else {
+        out << "no samples\n";
+    }
+    out << "  input delay: " << inputDelay << " ticks, stalled frames: " << m_stats.stalledFrames << "\n";
+}
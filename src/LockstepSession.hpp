@@ -0,0 +1,184 @@
+#pragma once
+
+#include "NetCodec.hpp"
+#include "UdpSocket.hpp"
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+// One player's commands for one simulation tick
+struct PlayerInput {
+    bool up = false;
+    bool down = false;
+    bool left = false;
+    bool right = false;
+    bool fire = false;      // Fire a bullet toward the aim point
+    bool supermove = false; // Trigger the supermove
+    int32_t aimX = 0;       // Aim point in whole pixels
+    int32_t aimY = 0;
+};
+
+// Quantized state of one entity in a world keyframe
+struct EntitySnapshot {
+    uint32_t id;
+    int32_t x, y;   // Position (fixed point, see netQuantumScale)
+    int32_t vx, vy; // Velocity (fixed point)
+};
+
+// Bandwidth and latency counters for one session
+struct NetStats {
+    uint64_t bytesSent = 0;
+    uint64_t bytesReceived = 0;
+    uint64_t packetsSent = 0;
+    uint64_t packetsReceived = 0;
+    uint64_t keyframeBytes = 0;     // Part of bytesSent spent on keyframes
+    uint32_t keyframesSent = 0;
+    uint32_t keyframesReceived = 0;
+    uint32_t ticks = 0;             // Simulation ticks completed
+    uint32_t stalledFrames = 0;     // Frames that waited on a remote input
+    uint32_t corrections = 0;       // Entities that disagreed with a keyframe
+    uint32_t truncatedPackets = 0;  // Datagrams longer than the receive buffer (dropped unread)
+    double rttSumMs = 0.0;
+    double rttMinMs = 0.0;
+    double rttMaxMs = 0.0;
+    uint32_t rttSamples = 0;
+};
+
+// Deterministic lockstep session over UDP (host/client star)
+// Every peer runs the full simulation; only inputs are exchanged each tick.
+// A local input sampled at tick t is applied at t + inputDelay on every peer,
+// and a tick only runs once all players' inputs for it have arrived.
+// Inputs are resent redundantly until acknowledged, so no retransmit timers
+// are needed. Every keyframeInterval ticks the host also sends a quantized
+// world keyframe, delta encoded against the last keyframe that client
+// acknowledged, which clients use to detect and correct drift. A keyframe is
+// split into datagrams of at most maxPacketSize, each carrying a run of
+// entities; the client acknowledges it once every run has arrived.
+class LockstepSession {
+public:
+    static constexpr uint32_t inputDelay = 3;        // Ticks between sampling and applying an input
+    static constexpr uint32_t keyframeInterval = 60; // Ticks between world keyframes
+    static constexpr uint32_t maxInputWindow = 32;   // Most ticks of inputs carried by one packet
+    static constexpr uint32_t noTick = 0xFFFFFFFF;
+
+    // Open a session on the given port and wait for players - 1 clients
+    bool host(uint16_t port, int players);
+
+    // Connect to a host at "address:port"
+    bool join(const std::string& address);
+
+    // Receive pending packets and send this frame's updates; call once per frame
+    void service();
+
+    bool started() const { return m_started; }
+    bool isHost() const { return m_isHost; }
+    uint32_t seed() const { return m_seed; }
+    int playerCount() const { return m_players; }
+    int localSlot() const { return m_localSlot; }
+
+    // === Inputs ===
+    void submitLocalInput(uint32_t tick, const PlayerInput& input);
+    bool hasLocalInput(uint32_t tick) const;
+    // True when every input for tick is known. Clients also hold the tick after a
+    // keyframe tick briefly until that keyframe arrives, so it can be applied first.
+    bool readyToStep(uint32_t tick);
+    const std::vector<PlayerInput>& inputs(uint32_t tick) const { return m_ticks.at(tick).inputs; }
+    void endTick(uint32_t tick);                     // Tick fully simulated
+    void noteStall() { ++m_stats.stalledFrames; }    // Frame spent waiting on inputs
+
+    // === Keyframes ===
+    // Host: send the world state after tick to every client
+    void sendKeyframe(uint32_t tick, std::vector<EntitySnapshot> world);
+    // Client: fetch the keyframe taken after tick, if it has arrived
+    bool takeKeyframe(uint32_t tick, std::vector<EntitySnapshot>& out) const;
+    void noteCorrections(uint32_t count) { m_stats.corrections += count; }
+
+    const NetStats& stats() const { return m_stats; }
+    void printStats(std::ostream& out) const;
+
+private:
+    enum PacketType : uint8_t {
+        Join = 1,  // Client -> host: request a slot
+        Start,     // Host -> client: seed, player count, slot
+        Input,     // Client -> host: unacknowledged local inputs
+        Inputs,    // Host -> client: everyone's inputs for complete ticks
+        Keyframe   // Host -> client: one run of entities of a delta-encoded world state
+    };
+
+    struct TickInputs {
+        std::vector<PlayerInput> inputs;
+        uint32_t receivedMask = 0; // Bit per slot
+    };
+
+    struct Peer {
+        NetAddress address;
+        int slot = 0;
+        bool confirmed = false;          // Sent at least one Input (so it has Start)
+        uint32_t inputsUpTo = 0;         // Its inputs received for all ticks below this
+        uint32_t combinedAcked = 0;      // It has everyone's inputs for all ticks below this
+        uint32_t keyframeAck = noTick;   // Latest keyframe it decoded (our delta baseline)
+        uint16_t echoTime = 0;           // Latest timestamp it sent, echoed back for RTT
+                                         // (RTT samples include up to one frame of send delay)
+    };
+
+    // Client: a keyframe whose datagrams have not all arrived yet
+    struct PartialKeyframe {
+        uint32_t base = 0;                 // Baseline field shared by every chunk
+        std::vector<EntitySnapshot> world; // Sized to the whole keyframe, filled chunk by chunk
+        std::set<uint32_t> chunks;         // Index of the first entity of each chunk received
+        size_t received = 0;               // Entities filled in so far
+    };
+
+    void startSimulation();
+    void receive();
+    void handlePacket(const NetAddress& from, ByteReader& reader, uint8_t type, uint16_t echo);
+    void sendPacket(const NetAddress& to, const ByteWriter& packet, bool keyframe = false);
+    void writeHeader(ByteWriter& packet, PacketType type, uint16_t echo) const;
+    void sampleRtt(uint16_t echo);
+    void advanceComplete();
+    TickInputs& tickInputs(uint32_t tick);
+    uint16_t nowMs() const;
+
+    static void writeInput(ByteWriter& packet, const PlayerInput& input, const PlayerInput& previous);
+    static PlayerInput readInput(ByteReader& reader, const PlayerInput& previous);
+    // Writes entities of world from first on while the packet stays within
+    // maxPacketSize; returns the index after the last one written
+    static size_t writeKeyframe(ByteWriter& packet, const std::vector<EntitySnapshot>& world, size_t first,
+                                const std::vector<EntitySnapshot>* baseline);
+    // Reads entities up to the end of the packet
+    static bool readKeyframe(ByteReader& reader, std::vector<EntitySnapshot>& world,
+                             const std::vector<EntitySnapshot>* baseline);
+
+    UdpSocket m_socket;
+    bool m_isHost = false;
+    bool m_started = false;
+    uint32_t m_seed = 0;
+    int m_players = 1;
+    int m_localSlot = 0;
+    std::chrono::steady_clock::time_point m_epoch = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point m_lastJoin{};
+
+    std::map<uint32_t, TickInputs> m_ticks; // Inputs per tick (complete or in progress)
+    uint32_t m_completeUpTo = 0;            // All inputs known for every tick below this
+
+    // === Host State ===
+    std::vector<Peer> m_peers;
+    std::map<uint32_t, std::vector<EntitySnapshot>> m_sentKeyframes;
+
+    // === Client State ===
+    NetAddress m_hostAddress;
+    std::map<uint32_t, PlayerInput> m_localPending;   // Local inputs the host has not acknowledged
+    uint32_t m_localUpTo = 0;                         // Local input submitted for every tick below this
+    std::map<uint32_t, std::vector<EntitySnapshot>> m_receivedKeyframes;
+    std::map<uint32_t, PartialKeyframe> m_partialKeyframes; // Keyframes still missing chunks
+    uint32_t m_keyframeAck = noTick;
+    uint32_t m_keyframeWaitTick = noTick;             // Tick held back waiting for a keyframe
+    std::chrono::steady_clock::time_point m_keyframeWaitStart{};
+    uint16_t m_hostEcho = 0;
+
+    NetStats m_stats;
+};
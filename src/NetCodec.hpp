@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// === Wire Encoding Helpers ===
+// Unsigned values use LEB128 varints (7 bits per byte), signed values are
+// zigzag-mapped first so small negative deltas stay small on the wire.
+
+inline uint32_t zigzagEncode(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+inline int32_t zigzagDecode(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+// Positions and velocities travel as fixed point with 1/16 pixel precision
+constexpr float netQuantumScale = 16.0f;
+
+inline int32_t quantize(float value) {
+    return static_cast<int32_t>(std::lround(value * netQuantumScale));
+}
+
+inline float dequantize(int32_t value) {
+    return static_cast<float>(value) / netQuantumScale;
+}
+
+// Appends values to a packet buffer
+class ByteWriter {
+    std::vector<uint8_t> m_bytes;
+
+public:
+    void u8(uint8_t value) { m_bytes.push_back(value); }
+
+    void u16(uint16_t value) {
+        m_bytes.push_back(static_cast<uint8_t>(value));
+        m_bytes.push_back(static_cast<uint8_t>(value >> 8));
+    }
+
+    void u32(uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            m_bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void varint(uint32_t value) {
+        while (value >= 0x80) {
+            m_bytes.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        m_bytes.push_back(static_cast<uint8_t>(value));
+    }
+
+    void svarint(int32_t value) { varint(zigzagEncode(value)); }
+
+    void append(const ByteWriter& other) { m_bytes.insert(m_bytes.end(), other.m_bytes.begin(), other.m_bytes.end()); }
+
+    const std::vector<uint8_t>& bytes() const { return m_bytes; }
+    size_t size() const { return m_bytes.size(); }
+    void clear() { m_bytes.clear(); } // Keeps the capacity for the next packet
+};
+
+// Reads values from a received packet; reading past the end sets a failure
+// flag and returns zeros instead of throwing
+class ByteReader {
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_pos = 0;
+    bool m_failed = false;
+
+public:
+    ByteReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+    uint8_t u8() {
+        if (m_pos >= m_size) {
+            m_failed = true;
+            return 0;
+        }
+        return m_data[m_pos++];
+    }
+
+    uint16_t u16() {
+        uint16_t low = u8();
+        return static_cast<uint16_t>(low | (u8() << 8));
+    }
+
+    uint32_t u32() {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(u8()) << (8 * i);
+        }
+        return value;
+    }
+
+    uint32_t varint() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint8_t byte = u8();
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        m_failed = true; // Varint longer than 5 bytes
+        return 0;
+    }
+
+    int32_t svarint() { return zigzagDecode(varint()); }
+
+    bool failed() const { return m_failed; }
+    size_t remaining() const { return m_size - m_pos; }
+};
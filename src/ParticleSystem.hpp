@@ -0,0 +1,156 @@
+#pragma once
+
+#include "Vec2.hpp"
+#include "PolygonGeometry.hpp"
+#include "RenderCulling.hpp"
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Fixed-capacity particle pool for short-lived visual effects (explosion fragments)
+// Particles live in a ring buffer in structure-of-arrays layout: one contiguous
+// array per field, so integration is a handful of straight loops the compiler can
+// vectorize. Fade and rotation are computed from age instead of stored per frame.
+// When the pool is full, new particles overwrite the oldest ones.
+class ParticleSystem {
+    static constexpr int maxSides = maxPolygonSides; // Largest polygon a particle can have
+
+    size_t m_capacity;
+    size_t m_tail = 0;  // Oldest live particle
+    size_t m_count = 0; // Live particles (tail .. tail + count, wrapping)
+
+    // === Per-particle fields (SoA) ===
+    std::vector<float> m_x, m_y;         // Position
+    std::vector<float> m_vx, m_vy;       // Velocity
+    std::vector<float> m_age, m_life;    // Seconds alive, total lifespan
+    std::vector<float> m_radius;         // Polygon radius
+    std::vector<float> m_spin;           // Rotation speed (degrees per second)
+    std::vector<uint8_t> m_sides;        // Polygon side count
+    std::vector<uint8_t> m_r, m_g, m_b;  // Base color (alpha comes from age)
+
+    // Apply fn(begin, end) to the live range as at most two contiguous spans
+    template <typename Fn>
+    void forEachSpan(Fn&& fn) {
+        size_t first = std::min(m_count, m_capacity - m_tail);
+        fn(m_tail, m_tail + first);
+        fn(size_t{0}, m_count - first);
+    }
+
+public:
+    explicit ParticleSystem(size_t capacity = 16384)
+        : m_capacity(capacity),
+          m_x(capacity), m_y(capacity), m_vx(capacity), m_vy(capacity),
+          m_age(capacity), m_life(capacity), m_radius(capacity), m_spin(capacity),
+          m_sides(capacity), m_r(capacity), m_g(capacity), m_b(capacity) {}
+
+    // Spawn count particles evenly spread around center, flying outward at speed
+    void spawnBurst(const Vec2<float>& center, int count, float speed, float radius,
+                    int sides, const sf::Color& color, float lifetime, float spin) {
+        sides = std::clamp(sides, 3, maxSides);
+        for (int i = 0; i < count; ++i) {
+            float angle = (2.0f * static_cast<float>(M_PI) / count) * i;
+
+            size_t slot;
+            if (m_count < m_capacity) {
+                slot = (m_tail + m_count) % m_capacity;
+                ++m_count;
+            } else {
+                slot = m_tail; // Full: recycle the oldest particle
+                m_tail = (m_tail + 1) % m_capacity;
+            }
+
+            m_x[slot] = center.x;
+            m_y[slot] = center.y;
+            m_vx[slot] = std::cos(angle) * speed;
+            m_vy[slot] = std::sin(angle) * speed;
+            m_age[slot] = 0.0f;
+            m_life[slot] = lifetime;
+            m_radius[slot] = radius;
+            m_spin[slot] = spin;
+            m_sides[slot] = static_cast<uint8_t>(sides);
+            m_r[slot] = color.r;
+            m_g[slot] = color.g;
+            m_b[slot] = color.b;
+        }
+    }
+
+    // Advance all particles and retire expired ones from the tail
+    void update(float dt) {
+        float* x = m_x.data();
+        float* y = m_y.data();
+        float* age = m_age.data();
+        const float* vx = m_vx.data();
+        const float* vy = m_vy.data();
+        forEachSpan([&](size_t begin, size_t end) {
+            integrateBatch(x + begin, y + begin, vx + begin, vy + begin, end - begin, dt);
+            for (size_t i = begin; i < end; ++i) {
+                age[i] += dt;
+            }
+        });
+
+        // Particles of one burst share a lifespan, so expiry is nearly FIFO.
+        // Anything that dies out of order is skipped when building vertices.
+        while (m_count > 0 && m_age[m_tail] >= m_life[m_tail]) {
+            m_tail = (m_tail + 1) % m_capacity;
+            --m_count;
+        }
+    }
+
+    // Append each visible particle as a polygon outline (triangle list) to out
+    // Matches the look of an sf::CircleShape with a transparent fill and the
+    // given outline thickness. Particles off screen or faded out are skipped,
+    // and ones a pixel or two across become a single quad.
+    void appendVertices(std::vector<sf::Vertex>& out, float outlineThickness, const RenderView& view) const {
+        for (size_t n = 0; n < m_count; ++n) {
+            size_t i = (m_tail + n) % m_capacity;
+            float t = m_age[i] / m_life[i];
+            if (t >= 1.0f) {
+                continue;
+            }
+
+            // Analytic fade and rotation from age
+            sf::Color color(m_r[i], m_g[i], m_b[i], static_cast<sf::Uint8>((1.0f - t) * 255.0f));
+            int sides = m_sides[i];
+            float inner = m_radius[i];
+            float outer = inner + outlineThickness / std::cos(static_cast<float>(M_PI) / sides); // Miter at corners
+            if (color.a < minVisibleAlpha || !view.visible(m_x[i], m_y[i], outer)) {
+                continue;
+            }
+            if (outer < pointSpriteRadius) {
+                appendQuad(out, m_x[i], m_y[i], outer, color);
+                continue;
+            }
+
+            float radian = m_spin[i] * m_age[i] * static_cast<float>(M_PI) / 180.0f;
+            float c = std::cos(radian), s = std::sin(radian);
+            const auto& unit = unitPolygon(sides);
+
+            auto corner = [&](int k, float r) {
+                const auto& u = unit[k % sides];
+                return sf::Vector2f(m_x[i] + (u.x * c - u.y * s) * r, m_y[i] + (u.x * s + u.y * c) * r);
+            };
+
+            for (int k = 0; k < sides; ++k) {
+                sf::Vector2f in0 = corner(k, inner), in1 = corner(k + 1, inner);
+                sf::Vector2f out0 = corner(k, outer), out1 = corner(k + 1, outer);
+                out.emplace_back(in0, color);
+                out.emplace_back(out0, color);
+                out.emplace_back(out1, color);
+                out.emplace_back(in0, color);
+                out.emplace_back(out1, color);
+                out.emplace_back(in1, color);
+            }
+        }
+    }
+
+    size_t size() const { return m_count; }
+
+    size_t capacity() const { return m_capacity; }
+
+    void clear() {
+        m_tail = 0;
+        m_count = 0;
+    }
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Vec2.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// === Polygon Geometry ===
+// Shapes are regular 3-8 sided polygons, drawn like sf::CircleShape: corner k
+// at k * 360 / sides degrees from the top, rotated clockwise by the entity's
+// angle. Unit corners are computed once per side count and shared by
+// collision, particles and rendering.
+
+constexpr int maxPolygonSides = 8;
+
+using PolygonPoints = std::array<Vec2<float>, maxPolygonSides>;
+
+// Corners of the unit polygon with this many sides (first corner at the top)
+inline const PolygonPoints& unitPolygon(int sides) {
+    static const auto table = [] {
+        std::array<PolygonPoints, maxPolygonSides + 1> t{};
+        for (int n = 3; n <= maxPolygonSides; ++n) {
+            for (int k = 0; k < n; ++k) {
+                float angle = k * 2.0f * static_cast<float>(M_PI) / n - static_cast<float>(M_PI) / 2.0f;
+                t[n][k] = Vec2<float>(std::cos(angle), std::sin(angle));
+            }
+        }
+        return t;
+    }();
+    return table[std::clamp(sides, 3, maxPolygonSides)];
+}
+
+// Rotated corners and outward edge normals of one polygon, relative to its center
+// Edge k runs from corner k to corner k + 1.
+struct PolygonShape {
+    int sides = 0;
+    PolygonPoints vertices{};
+    PolygonPoints normals{};
+
+    void build(int sideCount, float radius, float angleDegrees) {
+        sides = std::clamp(sideCount, 3, maxPolygonSides);
+        const PolygonPoints& unit = unitPolygon(sides);
+        float radian = angleDegrees * static_cast<float>(M_PI) / 180.0f;
+        float c = std::cos(radian), s = std::sin(radian);
+        for (int k = 0; k < sides; ++k) {
+            vertices[k] = Vec2<float>((unit[k].x * c - unit[k].y * s) * radius, (unit[k].x * s + unit[k].y * c) * radius);
+        }
+        // Regular polygon: the normal of edge k points at the middle of the edge
+        float half = static_cast<float>(M_PI) / sides;
+        for (int k = 0; k < sides; ++k) {
+            float edge = k * 2.0f * half - static_cast<float>(M_PI) / 2.0f + half + radian;
+            normals[k] = Vec2<float>(std::cos(edge), std::sin(edge));
+        }
+    }
+};
+
+// Separating axis test between two convex polygons centered at ca and cb
+inline bool polygonsOverlap(const PolygonShape& a, const Vec2<float>& ca, const PolygonShape& b, const Vec2<float>& cb) {
+    Vec2<float> offset = cb - ca;
+    auto separated = [&](const PolygonShape& axes, const PolygonShape& other, float sign) {
+        for (int k = 0; k < axes.sides; ++k) {
+            const Vec2<float>& n = axes.normals[k];
+            float extent = axes.vertices[k].x * n.x + axes.vertices[k].y * n.y; // Apothem along its own normal
+            float distance = (offset.x * n.x + offset.y * n.y) * sign;
+            float otherMin = distance;
+            for (int v = 0; v < other.sides; ++v) {
+                otherMin = std::min(otherMin, distance + other.vertices[v].x * n.x + other.vertices[v].y * n.y);
+            }
+            if (otherMin > extent) {
+                return true;
+            }
+        }
+        return false;
+    };
+    // Axes of a look at b from a (offset), axes of b look at a (negated offset)
+    return !separated(a, b, 1.0f) && !separated(b, a, -1.0f);
+}
+
+inline float pointSegmentDistanceSquared(const Vec2<float>& p, const Vec2<float>& a, const Vec2<float>& b) {
+    Vec2<float> ab = b - a;
+    float lengthSq = ab.x * ab.x + ab.y * ab.y;
+    float t = lengthSq > 0.0f ? std::clamp(((p.x - a.x) * ab.x + (p.y - a.y) * ab.y) / lengthSq, 0.0f, 1.0f) : 0.0f;
+    float dx = a.x + ab.x * t - p.x;
+    float dy = a.y + ab.y * t - p.y;
+    return dx * dx + dy * dy;
+}
+
+// Circle of radius r moving from p0 to p1 against a polygon centered at center
+// (motion relative to the polygon). True if it touches the polygon at any point.
+inline bool sweptCirclePolygon(const Vec2<float>& p0, const Vec2<float>& p1, float r,
+                               const PolygonShape& polygon, const Vec2<float>& center) {
+    Vec2<float> a = p0 - center, b = p1 - center;
+
+    // Start inside: every edge has the point on its inner side
+    bool inside = true;
+    for (int k = 0; k < polygon.sides && inside; ++k) {
+        const Vec2<float>& v = polygon.vertices[k];
+        inside = (a.x - v.x) * polygon.normals[k].x + (a.y - v.y) * polygon.normals[k].y <= 0.0f;
+    }
+    if (inside) {
+        return true;
+    }
+
+    // Otherwise the path must come within r of an edge (or cross it)
+    float rSq = r * r;
+    Vec2<float> ab = b - a;
+    for (int k = 0; k < polygon.sides; ++k) {
+        const Vec2<float>& v0 = polygon.vertices[k];
+        const Vec2<float>& v1 = polygon.vertices[(k + 1) % polygon.sides];
+        Vec2<float> edge = v1 - v0;
+        float d0 = ab.x * (v0.y - a.y) - ab.y * (v0.x - a.x);
+        float d1 = ab.x * (v1.y - a.y) - ab.y * (v1.x - a.x);
+        float e0 = edge.x * (a.y - v0.y) - edge.y * (a.x - v0.x);
+        float e1 = edge.x * (b.y - v0.y) - edge.y * (b.x - v0.x);
+        if (((d0 < 0.0f) != (d1 < 0.0f)) && ((e0 < 0.0f) != (e1 < 0.0f))) {
+            return true; // Path crosses the edge
+        }
+        if (pointSegmentDistanceSquared(a, v0, v1) <= rSq || pointSegmentDistanceSquared(b, v0, v1) <= rSq ||
+            pointSegmentDistanceSquared(v0, a, b) <= rSq || pointSegmentDistanceSquared(v1, a, b) <= rSq) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Load-shedding settings for one quality level
+struct QualityLevel {
+    float fragmentScale;     // Fragments per explosion, relative to the enemy's side count
+    float fragmentLifeScale; // Fragment lifetime multiplier
+    float outlineScale;      // Enemy and fragment outline thickness multiplier
+    int bulletSides;         // Sides pattern bullets are drawn with
+    int enemySolverInterval; // Enemy-enemy contacts are resolved every n-th step
+    float hudInterval;       // Seconds between HUD text refreshes (0 = every update)
+};
+
+// Holds frames inside a work budget by stepping through quality levels
+// Each frame reports its work (simulation plus render, not the vsync wait)
+// and the governor keeps a moving average. Above 90% of the budget it sheds
+// one level; only after the average has stayed under 50% for a few seconds
+// does it restore one. Every change is followed by a hold period, so a level
+// is never left before its effect shows up in the average. A budget of 0
+// keeps full quality.
+class QualityGovernor {
+public:
+    static constexpr std::array<QualityLevel, 4> levels = {{
+        {1.0f, 1.0f, 1.0f, 8, 1, 0.0f},     // Full quality
+        {0.75f, 0.75f, 0.75f, 6, 1, 0.1f},
+        {0.5f, 0.5f, 0.5f, 5, 2, 0.25f},
+        {0.25f, 0.4f, 0.25f, 4, 3, 0.5f},   // Lowest
+    }};
+
+    static constexpr double shedThreshold = 0.9;    // Of the budget
+    static constexpr double restoreThreshold = 0.5;
+    static constexpr uint32_t holdFrames = 30;      // After any change
+    static constexpr uint32_t restoreFrames = 180;  // Calm frames needed to restore a level
+    static constexpr double smoothing = 0.1;        // Moving average weight of the newest frame
+
+    explicit QualityGovernor(double budgetMs = 0.0) : m_budgetMs(budgetMs) {}
+
+    void setBudget(double budgetMs) { m_budgetMs = budgetMs; }
+
+    // Feeds one frame's work; returns true when the level changed
+    bool record(double workMs) {
+        if (m_budgetMs <= 0.0) {
+            return false;
+        }
+        m_averageMs += (workMs - m_averageMs) * smoothing;
+        if (++m_framesSinceChange < holdFrames) {
+            return false;
+        }
+
+        if (m_averageMs > m_budgetMs * shedThreshold) {
+            m_calmFrames = 0;
+            return change(m_level + 1);
+        }
+        if (m_averageMs < m_budgetMs * restoreThreshold) {
+            if (++m_calmFrames >= restoreFrames) {
+                return change(m_level - 1);
+            }
+        } else {
+            m_calmFrames = 0;
+        }
+        return false;
+    }
+
+    const QualityLevel& settings() const { return levels[static_cast<size_t>(m_level)]; }
+    int level() const { return m_level; }
+    double averageMs() const { return m_averageMs; }
+
+private:
+    bool change(int level) {
+        if (level < 0 || level >= static_cast<int>(levels.size())) {
+            return false;
+        }
+        m_level = level;
+        m_framesSinceChange = 0;
+        m_calmFrames = 0;
+        return true;
+    }
+
+    double m_budgetMs;
+    double m_averageMs = 0.0;
+    int m_level = 0;
+    uint32_t m_framesSinceChange = 0;
+    uint32_t m_calmFrames = 0;
+};
@@ -0,0 +1,226 @@
+#pragma once
+
+#include "Vec2.hpp" // SIMD detection (VEC2_SSE / VEC2_NEON) and intrinsics
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// === Counter-Based Random Streams ===
+// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3")
+// turns a 128-bit counter and a 64-bit key into four random words with ten
+// multiply/xor rounds. There is no hidden state: draw i of a stream is a pure
+// function of (seed, stream, substream, i), so streams never overlap, any
+// draw can be computed directly, and work split across threads draws the
+// same numbers whatever the thread count. The counter holds the block index
+// (words 0-1), the stream (word 2) and the substream (word 3); the seed is
+// the key.
+
+// Independent streams derived from one session seed, one per consumer
+enum class RandomStreamId : uint32_t {
+    Spawns = 1, // Enemy positions, headings and shapes; player shapes
+    Colors,     // Enemy and player colors
+    Bot,        // BotController random walk
+};
+
+using PhiloxBlock = std::array<uint32_t, 4>;
+
+namespace philox {
+
+constexpr uint32_t multiplier0 = 0xD2511F53u;
+constexpr uint32_t multiplier1 = 0xCD9E8D57u;
+constexpr uint32_t weyl0 = 0x9E3779B9u; // Key schedule increments
+constexpr uint32_t weyl1 = 0xBB67AE85u;
+constexpr int rounds = 10;
+
+inline PhiloxBlock block(PhiloxBlock counter, uint32_t key0, uint32_t key1) {
+    for (int round = 0; round < rounds; ++round) {
+        uint64_t product0 = static_cast<uint64_t>(multiplier0) * counter[0];
+        uint64_t product1 = static_cast<uint64_t>(multiplier1) * counter[2];
+        counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key0, static_cast<uint32_t>(product1),
+                   static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key1, static_cast<uint32_t>(product0)};
+        key0 += weyl0;
+        key1 += weyl1;
+    }
+    return counter;
+}
+
+// Four consecutive blocks (first, first + 1, ...) of one stream into out[16],
+// in the same order as four calls to block(). Vectorized where available.
+inline void blocks4(uint64_t first, uint32_t stream, uint32_t substream, uint32_t key0, uint32_t key1, uint32_t* out) {
+#if defined(VEC2_SSE)
+    // Lane j holds word w of block first + j; 32x32->64 products are formed
+    // for the even and odd lanes separately and split into high and low words
+    auto mulhilo = [](__m128i a, __m128i m, __m128i& hi, __m128i& lo) {
+        __m128i even = _mm_mul_epu32(a, m);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+        lo = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+        hi = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 3, 1)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 3, 1)));
+    };
+    __m128i c0 = _mm_setr_epi32(static_cast<int>(static_cast<uint32_t>(first)), static_cast<int>(static_cast<uint32_t>(first + 1)),
+                                static_cast<int>(static_cast<uint32_t>(first + 2)), static_cast<int>(static_cast<uint32_t>(first + 3)));
+    __m128i c1 = _mm_setr_epi32(static_cast<int>(static_cast<uint32_t>(first >> 32)), static_cast<int>(static_cast<uint32_t>((first + 1) >> 32)),
+                                static_cast<int>(static_cast<uint32_t>((first + 2) >> 32)), static_cast<int>(static_cast<uint32_t>((first + 3) >> 32)));
+    __m128i c2 = _mm_set1_epi32(static_cast<int>(stream));
+    __m128i c3 = _mm_set1_epi32(static_cast<int>(substream));
+    const __m128i m0 = _mm_set1_epi32(static_cast<int>(multiplier0));
+    const __m128i m1 = _mm_set1_epi32(static_cast<int>(multiplier1));
+    for (int round = 0; round < rounds; ++round) {
+        __m128i hi0, lo0, hi1, lo1;
+        mulhilo(c0, m0, hi0, lo0);
+        mulhilo(c2, m1, hi1, lo1);
+        c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), _mm_set1_epi32(static_cast<int>(key0)));
+        c1 = lo1;
+        c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), _mm_set1_epi32(static_cast<int>(key1)));
+        c3 = lo0;
+        key0 += weyl0;
+        key1 += weyl1;
+    }
+    // Transpose words-by-lane into block order
+    __m128i t0 = _mm_unpacklo_epi32(c0, c1), t1 = _mm_unpacklo_epi32(c2, c3);
+    __m128i t2 = _mm_unpackhi_epi32(c0, c1), t3 = _mm_unpackhi_epi32(c2, c3);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi64(t0, t1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi64(t0, t1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi64(t2, t3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi64(t2, t3));
+#elif defined(VEC2_NEON)
+    auto mulhilo = [](uint32x4_t a, uint32x4_t m, uint32x4_t& hi, uint32x4_t& lo) {
+        uint64x2_t low = vmull_u32(vget_low_u32(a), vget_low_u32(m));
+        uint64x2_t high = vmull_high_u32(a, m);
+        lo = vcombine_u32(vmovn_u64(low), vmovn_u64(high));
+        hi = vcombine_u32(vshrn_n_u64(low, 32), vshrn_n_u64(high, 32));
+    };
+    const uint32_t low[4] = {static_cast<uint32_t>(first), static_cast<uint32_t>(first + 1),
+                             static_cast<uint32_t>(first + 2), static_cast<uint32_t>(first + 3)};
+    const uint32_t high[4] = {static_cast<uint32_t>(first >> 32), static_cast<uint32_t>((first + 1) >> 32),
+                              static_cast<uint32_t>((first + 2) >> 32), static_cast<uint32_t>((first + 3) >> 32)};
+    uint32x4_t c0 = vld1q_u32(low), c1 = vld1q_u32(high);
+    uint32x4_t c2 = vdupq_n_u32(stream), c3 = vdupq_n_u32(substream);
+    const uint32x4_t m0 = vdupq_n_u32(multiplier0), m1 = vdupq_n_u32(multiplier1);
+    for (int round = 0; round < rounds; ++round) {
+        uint32x4_t hi0, lo0, hi1, lo1;
+        mulhilo(c0, m0, hi0, lo0);
+        mulhilo(c2, m1, hi1, lo1);
+        c0 = veorq_u32(veorq_u32(hi1, c1), vdupq_n_u32(key0));
+        c1 = lo1;
+        c2 = veorq_u32(veorq_u32(hi0, c3), vdupq_n_u32(key1));
+        c3 = lo0;
+        key0 += weyl0;
+        key1 += weyl1;
+    }
+    uint32x4x4_t words = {{c0, c1, c2, c3}};
+    vst4q_u32(out, words); // Interleaving store: block order
+#else
+    for (uint64_t j = 0; j < 4; ++j) {
+        uint64_t index = first + j;
+        PhiloxBlock words = block({static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32), stream, substream},
+                                  key0, key1);
+        for (size_t w = 0; w < 4; ++w) {
+            out[j * 4 + w] = words[w];
+        }
+    }
+#endif
+}
+
+} // namespace philox
+
+// One stream of random numbers: a position in the sequence of (seed, stream, substream)
+class RandomStream {
+public:
+    explicit RandomStream(uint64_t seed = 0, RandomStreamId stream = RandomStreamId::Spawns, uint32_t substream = 0)
+        : m_stream(static_cast<uint32_t>(stream)), m_substream(substream) {
+        this->seed(seed);
+    }
+
+    // Restarts the stream from the beginning of seed's sequence (stream and substream stay)
+    void seed(uint64_t seed) {
+        m_key0 = static_cast<uint32_t>(seed);
+        m_key1 = static_cast<uint32_t>(seed >> 32);
+        m_position = 0;
+        m_cached = ~uint64_t{0};
+    }
+
+    // An independent stream for one worker, job or entity of this system
+    RandomStream substream(uint32_t index) const {
+        RandomStream child(0, static_cast<RandomStreamId>(m_stream), index);
+        child.m_key0 = m_key0;
+        child.m_key1 = m_key1;
+        return child;
+    }
+
+    // === Draws ===
+    uint32_t next() {
+        uint64_t block = m_position >> 2;
+        if (block != m_cached) {
+            m_block = philox::block(counter(block), m_key0, m_key1);
+            m_cached = block;
+        }
+        return m_block[m_position++ & 3];
+    }
+
+    // Draw index of this stream, without moving the position
+    uint32_t at(uint64_t index) const {
+        return philox::block(counter(index >> 2), m_key0, m_key1)[index & 3];
+    }
+
+    // Uniform in [0, bound) without modulo bias (Lemire's multiply-shift; rarely redraws)
+    uint32_t below(uint32_t bound) {
+        uint64_t product = static_cast<uint64_t>(next()) * bound;
+        if (static_cast<uint32_t>(product) < bound) {
+            uint32_t threshold = (0u - bound) % bound;
+            while (static_cast<uint32_t>(product) < threshold) {
+                product = static_cast<uint64_t>(next()) * bound;
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+    // Uniform in [0, 1) with 24 bits, every value exactly representable
+    float uniform() { return toUnit(next()); }
+
+    static float toUnit(uint32_t bits) { return static_cast<float>(bits >> 8) * 0x1p-24f; }
+
+    // === Batches ===
+    // The next n draws, identical to n calls of next(); whole blocks come four at a time
+    void fill(uint32_t* out, size_t n) {
+        size_t i = 0;
+        while (i < n && (m_position & 3) != 0) {
+            out[i++] = next();
+        }
+        for (; i + 16 <= n; i += 16) {
+            philox::blocks4(m_position >> 2, m_stream, m_substream, m_key0, m_key1, out + i);
+            m_position += 16;
+        }
+        while (i < n) {
+            out[i++] = next();
+        }
+    }
+
+    // The next n draws as floats in [min, max)
+    void fillUniform(float* out, size_t n, float min, float max) {
+        uint32_t bits[64];
+        for (size_t begin = 0; begin < n; begin += 64) {
+            size_t count = std::min<size_t>(64, n - begin);
+            fill(bits, count);
+            for (size_t i = 0; i < count; ++i) {
+                out[begin + i] = min + toUnit(bits[i]) * (max - min);
+            }
+        }
+    }
+
+    // Draws taken so far (save and restore a stream with setPosition)
+    uint64_t position() const { return m_position; }
+    void setPosition(uint64_t position) { m_position = position; }
+
+private:
+    PhiloxBlock counter(uint64_t block) const {
+        return {static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32), m_stream, m_substream};
+    }
+
+    uint32_t m_key0 = 0, m_key1 = 0;   // The seed
+    uint32_t m_stream;                 // RandomStreamId
+    uint32_t m_substream;
+    uint64_t m_position = 0;           // Index of the next draw
+    uint64_t m_cached = ~uint64_t{0};  // Block held in m_block
+    PhiloxBlock m_block{};
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Vec2.hpp"
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+// === Render Culling and Level of Detail ===
+// World coordinates are window pixels (the default view), so a shape's radius
+// is its size on screen. Shapes outside the view or too faint to change a
+// pixel are skipped, circles get just enough sides for their edge to stay
+// within half a pixel of the true circle, and shapes only a few pixels across
+// are drawn as a single quad.
+
+constexpr sf::Uint8 minVisibleAlpha = 2;  // Fainter than this is not drawn
+constexpr float pointSpriteRadius = 1.5f; // Outer radius (px) below which a shape is one quad
+constexpr int maxCircleSides = 32;
+
+// The part of the world that is on screen
+struct RenderView {
+    float left = 0.0f, top = 0.0f, right = 0.0f, bottom = 0.0f;
+
+    // True if a shape at (x, y) reaching extent from its center touches the view
+    bool visible(float x, float y, float extent) const {
+        return x + extent >= left && x - extent <= right && y + extent >= top && y - extent <= bottom;
+    }
+};
+
+// Fewest sides (up to maxSides) that keep a circle of this radius within half a pixel
+inline int circleSides(float radius, int maxSides) {
+    int sides = radius > 0.5f ? static_cast<int>(std::ceil(static_cast<float>(M_PI) / std::acos(1.0f - 0.5f / radius))) : 3;
+    return std::clamp(sides, 3, std::clamp(maxSides, 3, maxCircleSides));
+}
+
+// Corners of the unit circle approximated by this many sides (first at the top, like unitPolygon)
+inline const std::array<Vec2<float>, maxCircleSides>& unitCircle(int sides) {
+    static const auto table = [] {
+        std::array<std::array<Vec2<float>, maxCircleSides>, maxCircleSides + 1> t{};
+        for (int n = 3; n <= maxCircleSides; ++n) {
+            for (int k = 0; k < n; ++k) {
+                float angle = k * 2.0f * static_cast<float>(M_PI) / n - static_cast<float>(M_PI) / 2.0f;
+                t[n][k] = Vec2<float>(std::cos(angle), std::sin(angle));
+            }
+        }
+        return t;
+    }();
+    return table[std::clamp(sides, 3, maxCircleSides)];
+}
+
+// A square of the given half size (two triangles): the "point sprite" for tiny shapes
+inline void appendQuad(std::vector<sf::Vertex>& out, float x, float y, float halfSize, const sf::Color& color) {
+    sf::Vector2f a(x - halfSize, y - halfSize), b(x + halfSize, y - halfSize);
+    sf::Vector2f c(x + halfSize, y + halfSize), d(x - halfSize, y + halfSize);
+    out.emplace_back(a, color);
+    out.emplace_back(b, color);
+    out.emplace_back(c, color);
+    out.emplace_back(a, color);
+    out.emplace_back(c, color);
+    out.emplace_back(d, color);
+}
+
+// A filled circle of the given side count as a triangle fan
+inline void appendDisc(std::vector<sf::Vertex>& out, float x, float y, float radius, int sides, const sf::Color& color) {
+    const auto& unit = unitCircle(sides);
+    sides = std::clamp(sides, 3, maxCircleSides);
+    for (int k = 0; k < sides; ++k) {
+        const auto& a = unit[k];
+        const auto& b = unit[(k + 1) % sides];
+        out.emplace_back(sf::Vector2f(x, y), color);
+        out.emplace_back(sf::Vector2f(x + a.x * radius, y + a.y * radius), color);
+        out.emplace_back(sf::Vector2f(x + b.x * radius, y + b.y * radius), color);
+    }
+}
+
+// A circle filled with fill and outlined outward by thickness, like an
+// sf::CircleShape with that many points; a quad when it is tiny on screen.
+// The outline is a disc of the outer radius under the fill (6 vertices per
+// side instead of 9 for a separate ring), so fill must be opaque.
+inline void appendOutlinedCircle(std::vector<sf::Vertex>& out, float x, float y, float radius, int sides,
+                                 float thickness, const sf::Color& fill, const sf::Color& outline) {
+    if (radius + thickness < pointSpriteRadius) {
+        appendQuad(out, x, y, radius + thickness, outline);
+        return;
+    }
+    sides = std::clamp(sides, 3, maxCircleSides);
+    float outer = radius + thickness / std::cos(static_cast<float>(M_PI) / sides); // Miter at corners
+    appendDisc(out, x, y, outer, sides, outline);
+    appendDisc(out, x, y, radius, sides, fill);
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Assets.hpp"
+#include <charconv>
 #include <fstream>
 #include <iostream>
 #include <map>
@@ -29,21 +31,38 @@ std::string getShapeName(int sides) {
 // Loads the best scores from a file into the provided map
 // The file should contain lines in the format: "shapeName score"
 // Example: "triangle 3000"
+// The file is memory mapped and parsed in place with std::from_chars.
 void loadBestScores(const std::string& filename, std::map<std::string, int>& bestScores) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    MappedFile file;
+    if (!file.open(filename)) {
         std::cerr << "Unable to open file: " << filename << "\n";
         return;
     }
 
-    // Read each line from the file and populate the map
-    std::string shape;
-    int score;
-    while (file >> shape >> score) {
+    const char* it = file.data();
+    const char* end = file.data() + file.size();
+    auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; };
+
+    // Read each "shape score" pair and populate the map
+    while (true) {
+        while (it != end && isSpace(*it)) ++it;
+        const char* nameBegin = it;
+        while (it != end && !isSpace(*it)) ++it;
+        if (nameBegin == it) {
+            break; // End of file
+        }
+        std::string shape(nameBegin, it);
+
+        while (it != end && isSpace(*it)) ++it;
+        int score = 0;
+        auto [next, error] = std::from_chars(it, end, score);
+        if (error != std::errc()) {
+            std::cerr << "Malformed score for " << shape << " in " << filename << "\n";
+            break;
+        }
         bestScores[shape] = score; // Store the score for the shape
+        it = next;
     }
-
-    file.close(); // Close the file when done
 }
 
 // Saves the current best scores to a file
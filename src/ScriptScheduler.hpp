@@ -0,0 +1,337 @@
+#pragma once
+
+#include "TimingWheel.hpp"
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// === Coroutine Frame Pool ===
+// Size-classed free lists for coroutine frames, so starting a script does not
+// hit the general heap and a suspended script costs only its frame. Frames
+// come from 64-byte classes up to 1 KB (larger frames use the heap). Blocks
+// are recycled, never returned to the system; a mutex keeps the pool usable
+// from games stepped on different threads (it is only taken when a script
+// starts or finishes, never while scripts run).
+class CoroutineFramePool {
+public:
+    static constexpr size_t granularity = 64;
+    static constexpr size_t classCount = 16;         // Up to 1 KB frames
+    static constexpr size_t blocksPerChunk = 64;
+
+    static CoroutineFramePool& instance() {
+        static CoroutineFramePool pool;
+        return pool;
+    }
+
+    void* allocate(size_t size) {
+        size_t sizeClass = (size + granularity - 1) / granularity;
+        if (sizeClass == 0 || sizeClass > classCount) {
+            return ::operator new(size);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_live;
+        FreeBlock*& head = m_free[sizeClass - 1];
+        if (!head) {
+            // Carve a new chunk into blocks of this class
+            size_t blockSize = sizeClass * granularity;
+            char* chunk = static_cast<char*>(::operator new(blockSize * blocksPerChunk));
+            m_chunks.push_back(chunk);
+            for (size_t i = 0; i < blocksPerChunk; ++i) {
+                auto* block = reinterpret_cast<FreeBlock*>(chunk + i * blockSize);
+                block->next = head;
+                head = block;
+            }
+        }
+        FreeBlock* block = head;
+        head = block->next;
+        return block;
+    }
+
+    void deallocate(void* pointer, size_t size) {
+        size_t sizeClass = (size + granularity - 1) / granularity;
+        if (sizeClass == 0 || sizeClass > classCount) {
+            ::operator delete(pointer);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_live;
+        auto* block = static_cast<FreeBlock*>(pointer);
+        block->next = m_free[sizeClass - 1];
+        m_free[sizeClass - 1] = block;
+    }
+
+    // Pooled frames currently in use
+    size_t live() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_live;
+    }
+
+    ~CoroutineFramePool() {
+        for (char* chunk : m_chunks) {
+            ::operator delete(chunk);
+        }
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    std::mutex m_mutex;
+    std::array<FreeBlock*, classCount> m_free{};
+    std::vector<char*> m_chunks;
+    size_t m_live = 0;
+};
+
+class ScriptScheduler;
+
+// === Script Task ===
+// A script is a coroutine returning ScriptTask. Scripts are started with
+// ScriptScheduler::start and can co_await another ScriptTask to run it to
+// completion as a step of their own.
+class ScriptTask {
+public:
+    struct promise_type {
+        std::coroutine_handle<> continuation;  // Script awaiting this one (null at the top level)
+        ScriptScheduler* scheduler = nullptr;  // Set for top-level scripts
+        size_t slot = 0;                       // Index in the scheduler's script list
+
+        ScriptTask get_return_object() { return ScriptTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        static void* operator new(size_t size) { return CoroutineFramePool::instance().allocate(size); }
+        static void operator delete(void* pointer, size_t size) { CoroutineFramePool::instance().deallocate(pointer, size); }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    ScriptTask(ScriptTask&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+    ScriptTask& operator=(ScriptTask&& other) noexcept {
+        if (this != &other) {
+            if (m_handle) {
+                m_handle.destroy();
+            }
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+    ~ScriptTask() {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    // Awaiting a task starts it; the awaiting script resumes when it finishes
+    bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        m_handle.promise().continuation = awaiting;
+        return m_handle;
+    }
+    void await_resume() const noexcept {}
+
+    Handle release() { return std::exchange(m_handle, nullptr); }
+
+private:
+    explicit ScriptTask(Handle handle) : m_handle(handle) {}
+    Handle m_handle;
+};
+
+// === Script Scheduler ===
+// Owns the running scripts and resumes each one only when what it waits for
+// has happened:
+//   co_await scripts.wait(2.0);                         // Delay (timing wheel, O(expired))
+//   co_await scripts.until([&] { return enemies < 5; }); // Condition, checked once per update
+//   auto kill = co_await scripts.next<EnemyKilled>();   // Next event passed to publish()
+// Scripts waiting on a delay or an event cost nothing per update.
+class ScriptScheduler {
+public:
+    ScriptScheduler() = default;
+    ScriptScheduler(const ScriptScheduler&) = delete;
+    ScriptScheduler& operator=(const ScriptScheduler&) = delete;
+    ~ScriptScheduler() { clear(); }
+
+    // Takes ownership of a script and runs it up to its first wait
+    void start(ScriptTask task) {
+        ScriptTask::Handle handle = task.release();
+        handle.promise().scheduler = this;
+        handle.promise().slot = m_scripts.size();
+        m_scripts.push_back(handle);
+        handle.resume();
+        reapFinished();
+    }
+
+    // Advances script time: resumes expired delays, then scripts whose condition now holds
+    void update(double dt) {
+        m_wheel.advance(dt, [](std::coroutine_handle<> handle) { handle.resume(); });
+
+        // Check conditions against a snapshot, so a script that starts waiting again is checked next update
+        m_checking.swap(m_conditions);
+        for (size_t i = 0; i < m_checking.size(); ++i) {
+            if (m_checking[i].check(m_checking[i].awaiter)) {
+                m_checking[i].handle.resume();
+            } else {
+                m_conditions.push_back(m_checking[i]);
+            }
+        }
+        m_checking.clear();
+
+        reapFinished();
+    }
+
+    // Resumes every script waiting for this event type (each receives a copy)
+    template <typename Event>
+    void publish(const Event& event) {
+        if (m_eventWaiters.empty()) {
+            return;
+        }
+        std::vector<std::coroutine_handle<>> waking;
+        waking.swap(m_waking); // Reuse capacity, but stay safe if a resumed script publishes too
+        for (size_t i = 0; i < m_eventWaiters.size();) {
+            if (m_eventWaiters[i].type == eventTag<Event>()) {
+                *static_cast<std::optional<Event>*>(m_eventWaiters[i].value) = event;
+                waking.push_back(m_eventWaiters[i].handle);
+                m_eventWaiters[i] = m_eventWaiters.back();
+                m_eventWaiters.pop_back();
+            } else {
+                ++i;
+            }
+        }
+        for (auto handle : waking) {
+            handle.resume();
+        }
+        waking.clear();
+        m_waking.swap(waking);
+        reapFinished();
+    }
+
+    // Destroys every script, whatever it is waiting for
+    void clear() {
+        m_wheel = TimingWheel<std::coroutine_handle<>>();
+        m_conditions.clear();
+        m_eventWaiters.clear();
+        for (auto handle : m_scripts) {
+            handle.destroy(); // Also destroys any sub-script it is awaiting
+        }
+        m_scripts.clear();
+        m_finished.clear();
+    }
+
+    size_t running() const { return m_scripts.size(); }
+
+    // === Awaitables ===
+    struct Delay {
+        ScriptScheduler& scheduler;
+        double seconds;
+
+        bool await_ready() const noexcept { return seconds <= 0.0; }
+        void await_suspend(std::coroutine_handle<> handle) { scheduler.m_wheel.schedule(seconds, handle); }
+        void await_resume() const noexcept {}
+    };
+
+    template <typename Predicate>
+    struct Until {
+        ScriptScheduler& scheduler;
+        Predicate predicate;
+
+        bool await_ready() { return predicate(); }
+        void await_suspend(std::coroutine_handle<> handle) {
+            scheduler.m_conditions.push_back(Condition{handle, this, [](void* awaiter) {
+                return static_cast<Until*>(awaiter)->predicate();
+            }});
+        }
+        void await_resume() const noexcept {}
+    };
+
+    template <typename Event>
+    struct Next {
+        ScriptScheduler& scheduler;
+        std::optional<Event> value;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) {
+            scheduler.m_eventWaiters.push_back(EventWaiter{handle, eventTag<Event>(), &value});
+        }
+        Event await_resume() { return std::move(*value); }
+    };
+
+    Delay wait(double seconds) { return Delay{*this, seconds}; }
+
+    template <typename Predicate>
+    Until<Predicate> until(Predicate predicate) { return Until<Predicate>{*this, std::move(predicate)}; }
+
+    template <typename Event>
+    Next<Event> next() { return Next<Event>{*this, std::nullopt}; }
+
+private:
+    friend struct ScriptTask::promise_type::FinalAwaiter;
+
+    struct Condition {
+        std::coroutine_handle<> handle;
+        void* awaiter;              // The Until awaiter, alive in the suspended frame
+        bool (*check)(void* awaiter);
+    };
+
+    struct EventWaiter {
+        std::coroutine_handle<> handle;
+        const void* type;           // eventTag<Event>()
+        void* value;                // std::optional<Event> in the suspended frame
+    };
+
+    // One address per event type, used to match waiters without RTTI
+    template <typename Event>
+    static const void* eventTag() {
+        static const char tag = 0;
+        return &tag;
+    }
+
+    // Top-level scripts that returned are destroyed outside of their own resume
+    void reapFinished() {
+        for (auto handle : m_finished) {
+            size_t slot = handle.promise().slot;
+            m_scripts[slot] = m_scripts.back();
+            m_scripts[slot].promise().slot = slot;
+            m_scripts.pop_back();
+            handle.destroy();
+        }
+        m_finished.clear();
+    }
+
+    TimingWheel<std::coroutine_handle<>> m_wheel;
+    std::vector<Condition> m_conditions;
+    std::vector<Condition> m_checking;           // Conditions being checked this update
+    std::vector<EventWaiter> m_eventWaiters;
+    std::vector<std::coroutine_handle<>> m_waking; // Event waiters being resumed by publish()
+    std::vector<ScriptTask::Handle> m_scripts;   // Running top-level scripts
+    std::vector<ScriptTask::Handle> m_finished;  // Top-level scripts waiting to be destroyed
+};
+
+inline std::coroutine_handle<> ScriptTask::promise_type::FinalAwaiter::await_suspend(
+    std::coroutine_handle<promise_type> handle) noexcept {
+    promise_type& promise = handle.promise();
+    if (promise.continuation) {
+        return promise.continuation; // Back to the awaiting script
+    }
+    if (promise.scheduler) {
+        promise.scheduler->m_finished.push_back(handle);
+    }
+    return std::noop_coroutine();
+}
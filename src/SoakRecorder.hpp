@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Collision work done in one update (reset at the start of updateCollisions)
+struct CollisionCounters {
+    uint64_t playerEnemyTests = 0; // Player-enemy overlap tests
+    uint64_t enemyPairTests = 0;   // Enemy-enemy overlap tests
+    uint64_t enemyContacts = 0;    // Enemy pairs found overlapping and pushed apart
+    uint64_t bulletTests = 0;      // Bullet-enemy swept tests after the broad phase
+    uint64_t bulletHits = 0;       // Enemies killed by bullets
+};
+
+// World state sampled after one update
+struct SoakSample {
+    size_t players = 0;
+    size_t enemies = 0;
+    size_t bullets = 0;
+    size_t entities = 0;
+    size_t particles = 0;
+    float maxEnemySpeed = 0.0f;   // Growth here is the runaway bounce we look for
+    float maxBulletSpeed = 0.0f;
+    double stepMs = 0.0;          // Cost of the update
+    CollisionCounters collisions;
+    size_t bulletsExpired = 0;    // Bullets that reached the end of their lifespan (misses)
+    size_t crowdedSpawns = 0;     // Spawns with no candidate clear of every other entity
+};
+
+// Writes one CSV row per interval of simulated time for long unattended runs
+// Entity counts and speeds are the peak within the interval, collision
+// counters, expired bullets and crowded spawns are totals, step cost is mean and max.
+class SoakRecorder {
+    std::ofstream m_file;
+    float m_interval = 1.0f;
+    float m_elapsed = 0.0f;     // Simulated time in the current interval
+    double m_time = 0.0;        // Simulated time since the start of the run
+    uint32_t m_restarts = 0;
+
+    uint64_t m_steps = 0;
+    double m_stepMsSum = 0.0;
+    SoakSample m_peak;
+
+public:
+    bool open(const std::string& path, float interval) {
+        m_file.open(path);
+        if (!m_file) {
+            std::cerr << "Failed to open soak log: " << path << std::endl;
+            return false;
+        }
+        m_interval = interval;
+        m_file << "time,restarts,players,enemies,bullets,entities,particles,"
+                  "player_enemy_tests,enemy_pair_tests,enemy_contacts,bullet_tests,bullet_hits,bullets_expired,"
+                  "crowded_spawns,max_enemy_speed,max_bullet_speed,step_ms_mean,step_ms_max\n";
+        return true;
+    }
+
+    bool isOpen() const { return m_file.is_open(); }
+    double time() const { return m_time; }
+    void noteRestart() { ++m_restarts; }
+
+    void record(const SoakSample& sample, float dt) {
+        m_peak.players = std::max(m_peak.players, sample.players);
+        m_peak.enemies = std::max(m_peak.enemies, sample.enemies);
+        m_peak.bullets = std::max(m_peak.bullets, sample.bullets);
+        m_peak.entities = std::max(m_peak.entities, sample.entities);
+        m_peak.particles = std::max(m_peak.particles, sample.particles);
+        m_peak.maxEnemySpeed = std::max(m_peak.maxEnemySpeed, sample.maxEnemySpeed);
+        m_peak.maxBulletSpeed = std::max(m_peak.maxBulletSpeed, sample.maxBulletSpeed);
+        m_peak.stepMs = std::max(m_peak.stepMs, sample.stepMs);
+        m_peak.collisions.playerEnemyTests += sample.collisions.playerEnemyTests;
+        m_peak.collisions.enemyPairTests += sample.collisions.enemyPairTests;
+        m_peak.collisions.enemyContacts += sample.collisions.enemyContacts;
+        m_peak.collisions.bulletTests += sample.collisions.bulletTests;
+        m_peak.collisions.bulletHits += sample.collisions.bulletHits;
+        m_peak.bulletsExpired += sample.bulletsExpired;
+        m_peak.crowdedSpawns += sample.crowdedSpawns;
+        m_stepMsSum += sample.stepMs;
+        ++m_steps;
+
+        m_time += dt;
+        m_elapsed += dt;
+        if (m_elapsed >= m_interval) {
+            writeRow();
+        }
+    }
+
+private:
+    void writeRow() {
+        if (m_file) {
+            const auto& c = m_peak.collisions;
+            m_file << m_time << ',' << m_restarts << ',' << m_peak.players << ',' << m_peak.enemies << ','
+                   << m_peak.bullets << ',' << m_peak.entities << ',' << m_peak.particles << ','
+                   << c.playerEnemyTests << ',' << c.enemyPairTests << ',' << c.enemyContacts << ','
+                   << c.bulletTests << ',' << c.bulletHits << ',' << m_peak.bulletsExpired << ',' << m_peak.crowdedSpawns << ','
+                   << m_peak.maxEnemySpeed << ',' << m_peak.maxBulletSpeed << ','
+                   << (m_steps ? m_stepMsSum / static_cast<double>(m_steps) : 0.0) << ',' << m_peak.stepMs << '\n';
+            m_file.flush(); // Keep the log useful if a soak run crashes
+        }
+        m_peak = SoakSample{};
+        m_stepMsSum = 0.0;
+        m_steps = 0;
+        m_elapsed -= m_interval; // Time past the boundary counts toward the next interval
+    }
+};
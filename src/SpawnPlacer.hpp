@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Collision.hpp"
+#include "EntityManager.hpp"
+#include "RandomStream.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// === Spawn Placement ===
+// Picks spawn points that keep clear of the players and of other enemies
+// Occupied points (the enemies and players given to begin(), plus every point
+// placed since) are indexed in a SpatialGrid, so checking a candidate only
+// visits the cells around it. Placement is Poisson-disk dart throwing with a
+// fixed number of candidates per point: the first candidate that clears every
+// minimum distance is taken, and when the field is too crowded for any of
+// them the one with the most room (best-candidate blue noise) is used. The
+// cost per spawn is therefore bounded whatever the density, and spawns never
+// fail. Candidates are drawn from the caller's stream in one batch.
+class SpawnPlacer {
+public:
+    float enemySpacing = 90.0f;     // Minimum distance between enemy centers
+    float playerClearance = 220.0f; // Minimum distance from a player's center
+    int attempts = 16;              // Candidates per placement
+
+    // Indexes the current enemies and players; call before placing a batch
+    void begin(const EntityVec& enemies, const EntityVec& players, float worldWidth, float worldHeight) {
+        m_points.clear();
+        m_grid.reset(worldWidth, worldHeight, std::max(std::max(enemySpacing, playerClearance), 1.0f));
+        for (const auto& enemy : enemies) {
+            if (enemy->isAlive()) {
+                occupy(enemy->get<CTransform>().position, enemySpacing);
+            }
+        }
+        for (const auto& player : players) {
+            if (player->isAlive()) {
+                occupy(player->get<CTransform>().position, playerClearance);
+            }
+        }
+    }
+
+    // A point in the box [min, max]; it counts as occupied for later placements
+    Vec2<float> place(RandomStream& random, const Vec2<float>& min, const Vec2<float>& max) {
+        return placeBest(random, nullptr, min, max);
+    }
+
+    // preferred itself if it is clear, otherwise a point within jitter of it (inside [min, max])
+    Vec2<float> placeNear(RandomStream& random, const Vec2<float>& preferred, float jitter,
+                          const Vec2<float>& min, const Vec2<float>& max) {
+        Vec2<float> low(std::max(min.x, preferred.x - jitter), std::max(min.y, preferred.y - jitter));
+        Vec2<float> high(std::min(max.x, preferred.x + jitter), std::min(max.y, preferred.y + jitter));
+        return placeBest(random, &preferred, low, high);
+    }
+
+    // One point near each preferred slot of a wave, in order; the wave's own
+    // points keep clear of each other as well as of the existing enemies
+    void placeMany(RandomStream& random, const std::vector<Vec2<float>>& preferred, float jitter,
+                   const Vec2<float>& min, const Vec2<float>& max, std::vector<Vec2<float>>& out) {
+        out.reserve(out.size() + preferred.size());
+        for (const auto& slot : preferred) {
+            out.push_back(placeNear(random, slot, jitter, min, max));
+        }
+    }
+
+    // Placements since the last call that had to settle for the candidate with the most room
+    size_t takeCrowded() { return std::exchange(m_crowded, size_t{0}); }
+
+private:
+    struct Occupied {
+        Vec2<float> position;
+        float clearance; // Candidates must stay at least this far away
+    };
+
+    void occupy(const Vec2<float>& position, float clearance) {
+        m_grid.insert(m_points.size(), position, position);
+        m_points.push_back({position, clearance});
+    }
+
+    // Distance the candidate has to spare against its tightest neighbour (>= 0 means clear)
+    float room(const Vec2<float>& candidate) const {
+        float reach = std::max(enemySpacing, playerClearance);
+        float best = std::numeric_limits<float>::infinity();
+        m_grid.queryBox(candidate - Vec2<float>(reach, reach), candidate + Vec2<float>(reach, reach), [&](size_t i) {
+            const Occupied& point = m_points[i];
+            Vec2<float> offset = candidate - point.position;
+            best = std::min(best, std::sqrt(offset.x * offset.x + offset.y * offset.y) - point.clearance);
+        });
+        return best;
+    }
+
+    Vec2<float> placeBest(RandomStream& random, const Vec2<float>* preferred, const Vec2<float>& min, const Vec2<float>& max) {
+        Vec2<float> best = preferred ? *preferred : min;
+        float bestRoom = preferred ? room(*preferred) : -std::numeric_limits<float>::infinity();
+
+        size_t count = static_cast<size_t>(std::max(attempts, 1));
+        m_xs.resize(count);
+        m_ys.resize(count);
+        random.fillUniform(m_xs.data(), count, min.x, max.x);
+        random.fillUniform(m_ys.data(), count, min.y, max.y);
+        for (size_t i = 0; i < count && bestRoom < 0.0f; ++i) {
+            Vec2<float> candidate(m_xs[i], m_ys[i]);
+            float candidateRoom = room(candidate);
+            if (candidateRoom > bestRoom) {
+                best = candidate;
+                bestRoom = candidateRoom;
+            }
+        }
+        if (bestRoom < 0.0f) {
+            ++m_crowded;
+        }
+        occupy(best, enemySpacing);
+        return best;
+    }
+
+    std::vector<Occupied> m_points;
+    SpatialGrid m_grid;
+    std::vector<float> m_xs, m_ys; // Candidate batch
+    size_t m_crowded = 0;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread
+// Head and tail live on separate cache lines so the two threads do not share
+// a line on every push/pop. Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    std::array<T, Capacity> m_items;
+    alignas(64) std::atomic<size_t> m_head{0}; // Next slot to read (written by the consumer)
+    alignas(64) std::atomic<size_t> m_tail{0}; // Next slot to write (written by the producer)
+
+public:
+    // Producer: returns false (dropping the item) when the queue is full
+    bool push(const T& item) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        m_items[tail & (Capacity - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: oldest item, or nullptr when empty (valid until pop)
+    const T* front() const {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &m_items[head & (Capacity - 1)];
+    }
+
+    // Consumer: discard the item returned by front
+    void pop() {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Records named milestones from construction until the first frame is shown
+// Marks are always recorded (a clock read each); printing is opt-in.
+class StartupTimeline {
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point m_start = Clock::now();
+    Clock::time_point m_last = m_start;
+    std::vector<std::pair<std::string, double>> m_marks; // Name, milliseconds since previous mark
+
+public:
+    // Close the current phase under the given name
+    void mark(const std::string& name) {
+        auto now = Clock::now();
+        m_marks.emplace_back(name, std::chrono::duration<double, std::milli>(now - m_last).count());
+        m_last = now;
+    }
+
+    // Print each phase and the running total
+    void print(std::ostream& out) const {
+        double total = 0.0;
+        out << "Startup timeline:\n";
+        for (const auto& [name, ms] : m_marks) {
+            total += ms;
+            out << "  " << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(2)
+                << std::setw(9) << ms << " ms  (total " << total << " ms)\n";
+        }
+    }
+};
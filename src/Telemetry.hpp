@@ -0,0 +1,485 @@
+#pragma once
+
+#include "EntityManager.hpp"
+#include "Components.hpp"
+#include "NetCodec.hpp"
+#include "SpscQueue.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// === Telemetry Records ===
+// World state sampled for review after the fact (density heatmaps, what led
+// up to a frame spike). One sample is every entity's transform and shape.
+
+enum class TelemetryKind : uint8_t { Other, Player, Enemy, Bullet, Clone };
+
+struct TelemetryEntity {
+    uint32_t id = 0;
+    TelemetryKind kind = TelemetryKind::Other;
+    uint8_t sides = 0;
+    float radius = 0.0f;
+    uint32_t color = 0;           // RGBA
+    float x = 0.0f, y = 0.0f;     // Position
+    float vx = 0.0f, vy = 0.0f;   // Velocity
+};
+
+struct TelemetrySample {
+    uint32_t timeMs = 0;                   // Game time when sampled
+    uint8_t qualityLevel = 0;              // QualityGovernor level at the time (0 = full quality)
+    std::vector<TelemetryEntity> entities; // Ascending id
+};
+
+inline const char* telemetryKindName(TelemetryKind kind) {
+    switch (kind) {
+    case TelemetryKind::Player: return "player";
+    case TelemetryKind::Enemy: return "enemy";
+    case TelemetryKind::Bullet: return "bullet";
+    case TelemetryKind::Clone: return "clone";
+    default: return "other";
+    }
+}
+
+// === File Format ===
+// header:  "SHTL" magic, version, sample interval (ticks)
+// chunk:   byte count, sample count, first and last sample time (ms), samples
+// index:   per chunk: file offset (low, high), first and last time (ms)
+// trailer: chunk count, index offset (low, high), "SHTI" magic
+// Every value is a little-endian u32. The first sample of a chunk is stored
+// whole, later ones as deltas against the sample before (1/16 pixel fixed
+// point, varints), so a reader seeking by time decodes at most one chunk. A
+// file without a trailer (the game crashed) is indexed by walking the chunks.
+
+constexpr uint32_t telemetryMagic = 0x4C544853;      // "SHTL"
+constexpr uint32_t telemetryIndexMagic = 0x49544853; // "SHTI"
+constexpr uint32_t telemetryVersion = 2;
+constexpr uint32_t telemetrySamplesPerChunk = 64;
+
+struct TelemetryChunkInfo {
+    uint64_t offset = 0;     // Of the chunk header
+    uint32_t firstMs = 0;
+    uint32_t lastMs = 0;
+};
+
+// Appends one sample to a chunk, delta coded against previous (null for the chunk's first)
+inline void encodeTelemetrySample(ByteWriter& out, const TelemetrySample& sample, const TelemetrySample* previous) {
+    out.varint(previous ? sample.timeMs - previous->timeMs : sample.timeMs);
+    out.u8(sample.qualityLevel);
+    out.varint(static_cast<uint32_t>(sample.entities.size()));
+
+    uint32_t lastId = 0;
+    size_t p = 0; // Walks previous in step, both are sorted by id
+    for (const auto& entity : sample.entities) {
+        out.varint(entity.id - lastId);
+        lastId = entity.id;
+
+        const TelemetryEntity* before = nullptr;
+        if (previous) {
+            while (p < previous->entities.size() && previous->entities[p].id < entity.id) {
+                ++p;
+            }
+            if (p < previous->entities.size() && previous->entities[p].id == entity.id) {
+                before = &previous->entities[p];
+            }
+        }
+
+        // Known entities with an unchanged shape send only how far they moved
+        bool known = before && before->kind == entity.kind && before->sides == entity.sides &&
+                     before->radius == entity.radius && before->color == entity.color;
+        out.u8(known ? 1 : 0);
+        if (known) {
+            out.svarint(quantize(entity.x) - quantize(before->x));
+            out.svarint(quantize(entity.y) - quantize(before->y));
+            out.svarint(quantize(entity.vx) - quantize(before->vx));
+            out.svarint(quantize(entity.vy) - quantize(before->vy));
+        } else {
+            out.u8(static_cast<uint8_t>(entity.kind));
+            out.u8(entity.sides);
+            out.svarint(quantize(entity.radius));
+            out.u32(entity.color);
+            out.svarint(quantize(entity.x));
+            out.svarint(quantize(entity.y));
+            out.svarint(quantize(entity.vx));
+            out.svarint(quantize(entity.vy));
+        }
+    }
+}
+
+// Reads the sample after previous (null for a chunk's first); false on malformed data
+inline bool decodeTelemetrySample(ByteReader& in, TelemetrySample& sample, const TelemetrySample* previous) {
+    sample.timeMs = in.varint() + (previous ? previous->timeMs : 0);
+    sample.qualityLevel = in.u8();
+    uint32_t count = in.varint();
+    if (in.failed() || count > in.remaining()) { // Every entity takes at least one byte
+        return false;
+    }
+    sample.entities.resize(count);
+
+    uint32_t lastId = 0;
+    size_t p = 0;
+    for (auto& entity : sample.entities) {
+        entity.id = lastId + in.varint();
+        lastId = entity.id;
+
+        if (in.u8() == 1) {
+            if (previous) {
+                while (p < previous->entities.size() && previous->entities[p].id < entity.id) {
+                    ++p;
+                }
+            }
+            if (!previous || p >= previous->entities.size() || previous->entities[p].id != entity.id) {
+                return false; // Delta against an entity the previous sample does not have
+            }
+            const TelemetryEntity& before = previous->entities[p];
+            entity = before;
+            entity.x = dequantize(quantize(before.x) + in.svarint());
+            entity.y = dequantize(quantize(before.y) + in.svarint());
+            entity.vx = dequantize(quantize(before.vx) + in.svarint());
+            entity.vy = dequantize(quantize(before.vy) + in.svarint());
+        } else {
+            entity.kind = static_cast<TelemetryKind>(in.u8());
+            entity.sides = in.u8();
+            entity.radius = dequantize(in.svarint());
+            entity.color = in.u32();
+            entity.x = dequantize(in.svarint());
+            entity.y = dequantize(in.svarint());
+            entity.vx = dequantize(in.svarint());
+            entity.vy = dequantize(in.svarint());
+        }
+    }
+    return !in.failed();
+}
+
+// === Telemetry Writer ===
+// Builds chunks and the index; used by the recorder's writer thread only.
+class TelemetryWriter {
+    std::ofstream m_file;
+    uint64_t m_offset = 0;                   // Bytes written so far
+    ByteWriter m_chunk;
+    uint32_t m_chunkSamples = 0;
+    uint32_t m_chunkFirstMs = 0;
+    TelemetrySample m_previous;              // Last sample added (delta base)
+    std::vector<TelemetryChunkInfo> m_index;
+
+    void writeU32(uint32_t value) {
+        char bytes[4];
+        for (int i = 0; i < 4; ++i) {
+            bytes[i] = static_cast<char>(value >> (8 * i));
+        }
+        m_file.write(bytes, 4);
+        m_offset += 4;
+    }
+
+    void flushChunk() {
+        if (m_chunkSamples == 0) {
+            return;
+        }
+        m_index.push_back(TelemetryChunkInfo{m_offset, m_chunkFirstMs, m_previous.timeMs});
+        writeU32(static_cast<uint32_t>(m_chunk.size()));
+        writeU32(m_chunkSamples);
+        writeU32(m_chunkFirstMs);
+        writeU32(m_previous.timeMs);
+        m_file.write(reinterpret_cast<const char*>(m_chunk.bytes().data()), static_cast<std::streamsize>(m_chunk.size()));
+        m_offset += m_chunk.size();
+        m_file.flush(); // A crash loses at most the chunk being built
+        m_chunk.clear();
+        m_chunkSamples = 0;
+    }
+
+public:
+    bool open(const std::string& path, uint32_t sampleInterval) {
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_file) {
+            std::cerr << "Failed to open telemetry file: " << path << std::endl;
+            return false;
+        }
+        writeU32(telemetryMagic);
+        writeU32(telemetryVersion);
+        writeU32(sampleInterval);
+        return true;
+    }
+
+    void add(const TelemetrySample& sample) {
+        if (m_chunkSamples == 0) {
+            m_chunkFirstMs = sample.timeMs;
+        }
+        encodeTelemetrySample(m_chunk, sample, m_chunkSamples == 0 ? nullptr : &m_previous);
+        m_previous.timeMs = sample.timeMs;
+        m_previous.entities.assign(sample.entities.begin(), sample.entities.end());
+        if (++m_chunkSamples == telemetrySamplesPerChunk) {
+            flushChunk();
+        }
+    }
+
+    // Writes the last chunk, the index and the trailer
+    void close() {
+        if (!m_file.is_open()) {
+            return;
+        }
+        flushChunk();
+        uint64_t indexOffset = m_offset;
+        for (const auto& chunk : m_index) {
+            writeU32(static_cast<uint32_t>(chunk.offset));
+            writeU32(static_cast<uint32_t>(chunk.offset >> 32));
+            writeU32(chunk.firstMs);
+            writeU32(chunk.lastMs);
+        }
+        writeU32(static_cast<uint32_t>(m_index.size()));
+        writeU32(static_cast<uint32_t>(indexOffset));
+        writeU32(static_cast<uint32_t>(indexOffset >> 32));
+        writeU32(telemetryIndexMagic);
+        m_file.close();
+    }
+
+    uint64_t bytesWritten() const { return m_offset; }
+};
+
+// === Telemetry Reader ===
+// Seeks straight to the chunks overlapping a time window.
+class TelemetryReader {
+    std::ifstream m_file;
+    uint64_t m_size = 0;
+    uint32_t m_sampleInterval = 0;
+    std::vector<TelemetryChunkInfo> m_index;
+
+    bool readU32(uint32_t& value) {
+        unsigned char bytes[4];
+        if (!m_file.read(reinterpret_cast<char*>(bytes), 4)) {
+            return false;
+        }
+        value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+        return true;
+    }
+
+    bool readIndex() {
+        if (m_size < 12 + 16) {
+            return false;
+        }
+        uint32_t count, low, high, magic;
+        m_file.seekg(static_cast<std::streamoff>(m_size - 16));
+        if (!readU32(count) || !readU32(low) || !readU32(high) || !readU32(magic) || magic != telemetryIndexMagic) {
+            return false;
+        }
+        m_file.seekg(static_cast<std::streamoff>(low | (static_cast<uint64_t>(high) << 32)));
+        for (uint32_t i = 0; i < count; ++i) {
+            TelemetryChunkInfo chunk;
+            if (!readU32(low) || !readU32(high) || !readU32(chunk.firstMs) || !readU32(chunk.lastMs)) {
+                return false;
+            }
+            chunk.offset = low | (static_cast<uint64_t>(high) << 32);
+            m_index.push_back(chunk);
+        }
+        return true;
+    }
+
+    // No trailer: walk the chunk headers, stopping at a torn chunk
+    void scanChunks() {
+        m_index.clear();
+        m_file.clear();
+        uint64_t offset = 12;
+        uint32_t bytes, samples;
+        TelemetryChunkInfo chunk;
+        m_file.seekg(static_cast<std::streamoff>(offset));
+        while (readU32(bytes) && readU32(samples) && readU32(chunk.firstMs) && readU32(chunk.lastMs) &&
+               offset + 16 + bytes <= m_size) {
+            chunk.offset = offset;
+            m_index.push_back(chunk);
+            offset += 16 + bytes;
+            m_file.seekg(static_cast<std::streamoff>(offset));
+        }
+    }
+
+public:
+    bool open(const std::string& path) {
+        m_file.open(path, std::ios::binary | std::ios::ate);
+        if (!m_file) {
+            std::cerr << "Unable to open file: " << path << std::endl;
+            return false;
+        }
+        m_size = static_cast<uint64_t>(m_file.tellg());
+        m_file.seekg(0);
+        uint32_t magic, version;
+        if (!readU32(magic) || !readU32(version) || !readU32(m_sampleInterval) ||
+            magic != telemetryMagic || version != telemetryVersion) {
+            std::cerr << "Not a telemetry file: " << path << std::endl;
+            return false;
+        }
+        if (!readIndex()) {
+            scanChunks();
+        }
+        return true;
+    }
+
+    // Calls fn(sample) for every sample with fromMs <= time <= toMs, in time order
+    template <typename Fn>
+    bool read(uint32_t fromMs, uint32_t toMs, Fn&& fn) {
+        std::vector<uint8_t> bytes;
+        TelemetrySample samples[2];
+        for (const auto& chunk : m_index) {
+            if (chunk.lastMs < fromMs || chunk.firstMs > toMs) {
+                continue;
+            }
+            uint32_t size, count, first, last;
+            m_file.clear();
+            m_file.seekg(static_cast<std::streamoff>(chunk.offset));
+            if (!readU32(size) || !readU32(count) || !readU32(first) || !readU32(last)) {
+                return false;
+            }
+            bytes.resize(size);
+            if (!m_file.read(reinterpret_cast<char*>(bytes.data()), size)) {
+                return false;
+            }
+
+            ByteReader in(bytes.data(), bytes.size());
+            for (uint32_t i = 0; i < count; ++i) {
+                TelemetrySample& sample = samples[i & 1];
+                if (!decodeTelemetrySample(in, sample, i == 0 ? nullptr : &samples[(i + 1) & 1])) {
+                    return false;
+                }
+                if (sample.timeMs >= fromMs && sample.timeMs <= toMs) {
+                    fn(static_cast<const TelemetrySample&>(sample));
+                }
+            }
+        }
+        return true;
+    }
+
+    const std::vector<TelemetryChunkInfo>& index() const { return m_index; }
+    uint32_t sampleInterval() const { return m_sampleInterval; }
+};
+
+// === Telemetry Recorder ===
+// Samples every entity's transform and shape every N updates and streams the
+// samples to a file on a background thread. Sample buffers are recycled
+// between the two threads through a pair of lock-free queues, so after
+// warm-up the game thread only copies the entity fields into a free buffer;
+// when the writer falls behind and no buffer is free, the sample is dropped
+// and counted instead of stalling the game.
+class TelemetryRecorder {
+public:
+    static constexpr size_t bufferCount = 64;
+
+    TelemetryRecorder() = default;
+    ~TelemetryRecorder() { close(); }
+
+    TelemetryRecorder(const TelemetryRecorder&) = delete;
+    TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+    bool open(const std::string& path, uint32_t sampleInterval) {
+        if (!m_writer.open(path, sampleInterval)) {
+            return false;
+        }
+        m_interval = std::max(1u, sampleInterval);
+        for (uint32_t i = 0; i < bufferCount; ++i) {
+            m_free.push(i);
+        }
+        m_running.store(true, std::memory_order_relaxed);
+        m_thread = std::thread(&TelemetryRecorder::run, this);
+        return true;
+    }
+
+    // Call once per update; every interval-th call samples the entities
+    void update(float dt, const EntityVec& entities, uint8_t qualityLevel) {
+        if (!isOpen()) {
+            return;
+        }
+        m_time += dt;
+        if (++m_ticks % m_interval != 0) {
+            return;
+        }
+
+        const uint32_t* slot = m_free.front();
+        if (!slot) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        uint32_t buffer = *slot;
+        m_free.pop();
+
+        TelemetrySample& sample = m_buffers[buffer];
+        sample.timeMs = static_cast<uint32_t>(m_time * 1000.0);
+        sample.qualityLevel = qualityLevel;
+        sample.entities.resize(entities.size());
+        for (size_t i = 0; i < entities.size(); ++i) {
+            const Entity& entity = *entities[i];
+            const auto& transform = entity.get<CTransform>();
+            const auto& shape = entity.get<CShape>();
+            TelemetryEntity& out = sample.entities[i];
+            out.id = static_cast<uint32_t>(entity.id());
+            out.kind = kindOf(entity.tag());
+            out.sides = static_cast<uint8_t>(shape.sides);
+            out.radius = shape.radius;
+            out.color = shape.color.toInteger();
+            out.x = transform.position.x;
+            out.y = transform.position.y;
+            out.vx = transform.velocity.x;
+            out.vy = transform.velocity.y;
+        }
+        m_full.push(buffer); // Never full: there are only bufferCount buffers
+    }
+
+    // Drains every queued sample and finishes the file
+    void close() {
+        if (!m_running.exchange(false)) {
+            return;
+        }
+        m_thread.join();
+        m_writer.close();
+        if (uint64_t dropped = m_dropped.load(std::memory_order_relaxed)) {
+            std::cerr << "Telemetry: " << dropped << " samples dropped (writer fell behind)" << std::endl;
+        }
+    }
+
+    bool isOpen() const { return m_thread.joinable(); }
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    static TelemetryKind kindOf(const std::string& tag) {
+        if (tag == "enemy") return TelemetryKind::Enemy;
+        if (tag == "bullet") return TelemetryKind::Bullet;
+        if (tag == "player") return TelemetryKind::Player;
+        if (tag == "clone") return TelemetryKind::Clone;
+        return TelemetryKind::Other;
+    }
+
+    void run() {
+        for (;;) {
+            bool running = m_running.load(std::memory_order_acquire); // Read before draining, so nothing is left behind
+            while (const uint32_t* slot = m_full.front()) {
+                uint32_t buffer = *slot;
+                m_full.pop();
+                TelemetrySample& sample = m_buffers[buffer];
+                // Entity order is storage order; the delta coder needs ids ascending
+                if (!std::is_sorted(sample.entities.begin(), sample.entities.end(),
+                                    [](const auto& a, const auto& b) { return a.id < b.id; })) {
+                    std::sort(sample.entities.begin(), sample.entities.end(),
+                              [](const auto& a, const auto& b) { return a.id < b.id; });
+                }
+                m_writer.add(sample);
+                m_free.push(buffer);
+            }
+            if (!running) {
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    std::array<TelemetrySample, bufferCount> m_buffers;
+    SpscQueue<uint32_t, bufferCount> m_free;  // Buffers the game thread may fill (writer -> game)
+    SpscQueue<uint32_t, bufferCount> m_full;  // Filled buffers waiting to be written (game -> writer)
+    TelemetryWriter m_writer;                 // Only touched by the writer thread while running
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<uint64_t> m_dropped{0};
+    uint32_t m_interval = 1;
+    uint64_t m_ticks = 0;                     // Updates since open
+    double m_time = 0.0;                      // Game time since open (seconds)
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that run one parallel loop at a time
+// The calling thread takes part in every loop, so a pool of size 1 has no
+// workers and runs everything inline. Items are handed out one at a time
+// through an atomic counter, which balances uneven items (games with very
+// different entity counts) without any per-item allocation.
+class ThreadPool {
+public:
+    // threads counts the caller; 0 means one per hardware thread
+    explicit ThreadPool(size_t threads = 0) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (size_t i = 1; i < threads; ++i) {
+            m_workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Calls body(i) for every i in [0, count) and returns once all calls finished
+    void parallelFor(size_t count, const std::function<void(size_t)>& body) {
+        if (count == 0) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_body = &body;
+            m_count = count;
+            m_next.store(0, std::memory_order_relaxed);
+            m_busy = m_workers.size();
+            ++m_generation;
+        }
+        m_wake.notify_all();
+
+        runItems();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_busy == 0; });
+        m_body = nullptr;
+    }
+
+    size_t size() const { return m_workers.size() + 1; }
+
+private:
+    void runItems() {
+        for (size_t i = m_next.fetch_add(1, std::memory_order_relaxed); i < m_count;
+             i = m_next.fetch_add(1, std::memory_order_relaxed)) {
+            (*m_body)(i);
+        }
+    }
+
+    void workerLoop() {
+        uint64_t seen = 0; // Last loop this worker took part in
+        for (;;) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seen; });
+            if (m_stopping) {
+                return;
+            }
+            seen = m_generation;
+            lock.unlock();
+
+            runItems();
+
+            lock.lock();
+            if (--m_busy == 0) {
+                m_done.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;  // A loop started (or the pool is stopping)
+    std::condition_variable m_done;  // The last worker finished the current loop
+    const std::function<void(size_t)>* m_body = nullptr;
+    size_t m_count = 0;
+    std::atomic<size_t> m_next{0};   // Next item to hand out
+    size_t m_busy = 0;               // Workers still inside the current loop
+    uint64_t m_generation = 0;       // Loops started so far
+    bool m_stopping = false;
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Hierarchical timing wheel: schedule a payload once, get it back when it is due
+// Time advances in fixed ticks (1 ms by default). Level 0 has 256 one-tick
+// slots; each higher level has 64 slots, each as wide as the whole level
+// below it. Far timers wait in a coarse slot and move down one level when the
+// level below wraps. Advancing costs one slot per tick plus the timers that
+// fire or move down, no matter how many timers are pending. There is no
+// cancellation: owners ignore payloads that no longer apply.
+template <typename Payload>
+class TimingWheel {
+    static constexpr int levels = 4;
+    static constexpr int level0Bits = 8;
+    static constexpr int levelBits = 6;
+    static constexpr uint64_t level0Slots = 1ull << level0Bits;
+    static constexpr uint64_t levelSlots = 1ull << levelBits;
+
+    struct Timer {
+        uint64_t due; // Tick at which the payload fires
+        Payload payload;
+    };
+
+    double m_tickSeconds;
+    uint64_t m_now = 0;            // Ticks advanced so far
+    double m_remainder = 0.0;      // Seconds not yet making up a whole tick
+    size_t m_pending = 0;
+    std::array<std::vector<std::vector<Timer>>, levels> m_slots;
+    std::vector<Timer> m_scratch;  // Slot being fired or moved down (its capacity is reused)
+
+    // Bit offset of a level's slot index within the tick count
+    static constexpr int shift(int level) { return level == 0 ? 0 : level0Bits + (level - 1) * levelBits; }
+
+    void insert(Timer&& timer) {
+        if (timer.due <= m_now) {
+            // Due now (moved down exactly on its tick): fire in the current level 0 slot
+            m_slots[0][m_now & (level0Slots - 1)].push_back(std::move(timer));
+            return;
+        }
+
+        uint64_t delta = timer.due - m_now;
+        if (delta < level0Slots) {
+            m_slots[0][timer.due & (level0Slots - 1)].push_back(std::move(timer));
+            return;
+        }
+        for (int level = 1; level < levels; ++level) {
+            uint64_t span = 1ull << shift(level + 1); // Ticks covered by this level and the ones below
+            if (delta < span || level == levels - 1) {
+                // Beyond the top level's reach, park in its furthest slot and re-place later
+                uint64_t due = delta < span ? timer.due : m_now + span - 1;
+                m_slots[level][(due >> shift(level)) & (levelSlots - 1)].push_back(std::move(timer));
+                return;
+            }
+        }
+    }
+
+    void cascade(int level) {
+        auto& slot = m_slots[level][(m_now >> shift(level)) & (levelSlots - 1)];
+        m_scratch.clear();
+        std::swap(m_scratch, slot);
+        for (auto& timer : m_scratch) {
+            insert(std::move(timer));
+        }
+    }
+
+    template <typename Fn>
+    void tick(Fn& onExpire) {
+        ++m_now;
+
+        // Higher levels move down first, so their timers can land in the level 0 slot fired below
+        if ((m_now & (level0Slots - 1)) == 0) {
+            int top = 1;
+            while (top < levels - 1 && ((m_now >> shift(top)) & (levelSlots - 1)) == 0) {
+                ++top;
+            }
+            for (int level = top; level >= 1; --level) {
+                cascade(level);
+            }
+        }
+
+        auto& slot = m_slots[0][m_now & (level0Slots - 1)];
+        if (slot.empty()) {
+            return;
+        }
+        m_scratch.clear();
+        std::swap(m_scratch, slot); // onExpire may schedule new timers
+        m_pending -= m_scratch.size();
+        for (auto& timer : m_scratch) {
+            onExpire(timer.payload);
+        }
+    }
+
+public:
+    explicit TimingWheel(double tickSeconds = 0.001) : m_tickSeconds(tickSeconds) {
+        m_slots[0].resize(level0Slots);
+        for (int level = 1; level < levels; ++level) {
+            m_slots[level].resize(levelSlots);
+        }
+    }
+
+    // Fire payload after delaySeconds (at least one tick from now)
+    void schedule(double delaySeconds, Payload payload) {
+        uint64_t ticks = static_cast<uint64_t>(std::max(1.0, std::ceil(delaySeconds / m_tickSeconds - 1e-9)));
+        insert(Timer{m_now + ticks, std::move(payload)});
+        ++m_pending;
+    }
+
+    // Move time forward, calling onExpire(payload) for every timer that comes due
+    template <typename Fn>
+    void advance(double seconds, Fn&& onExpire) {
+        m_remainder += seconds;
+        auto ticks = static_cast<uint64_t>(m_remainder / m_tickSeconds);
+        m_remainder -= static_cast<double>(ticks) * m_tickSeconds;
+        for (uint64_t i = 0; i < ticks; ++i) {
+            tick(onExpire);
+        }
+    }
+
+    // Seconds advanced since construction (whole ticks)
+    double now() const { return static_cast<double>(m_now) * m_tickSeconds; }
+    size_t pending() const { return m_pending; }
+};
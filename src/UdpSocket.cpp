@@ -0,0 +1,76 @@
+#include "UdpSocket.hpp"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+bool NetAddress::parse(const std::string& text, NetAddress& out) {
+    auto colon = text.rfind(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+    std::string host = text.substr(0, colon);
+    std::string port = text.substr(colon + 1);
+
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0 || !result) {
+        return false;
+    }
+    out.addr = *reinterpret_cast<sockaddr_in*>(result->ai_addr);
+    freeaddrinfo(result);
+    return true;
+}
+
+std::string NetAddress::toString() const {
+    char host[INET_ADDRSTRLEN] = {};
+    inet_ntop(AF_INET, &addr.sin_addr, host, sizeof(host));
+    return std::string(host) + ":" + std::to_string(ntohs(addr.sin_port));
+}
+
+UdpSocket::~UdpSocket() {
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+}
+
+bool UdpSocket::open(uint16_t port) {
+    m_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (m_fd < 0) {
+        return false;
+    }
+
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(port);
+    if (bind(m_fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+        close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    fcntl(m_fd, F_SETFL, fcntl(m_fd, F_GETFL, 0) | O_NONBLOCK);
+    return true;
+}
+
+bool UdpSocket::send(const NetAddress& to, const uint8_t* data, size_t size) {
+    ssize_t sent = sendto(m_fd, data, size, 0, reinterpret_cast<const sockaddr*>(&to.addr), sizeof(to.addr));
+    return sent == static_cast<ssize_t>(size);
+}
+
+size_t UdpSocket::receive(uint8_t* buffer, size_t capacity, NetAddress& from, bool& truncated) {
+    // recvmsg rather than recvfrom: only its flags say whether the datagram was cut
+    iovec data{buffer, capacity};
+    msghdr message{};
+    message.msg_name = &from.addr;
+    message.msg_namelen = sizeof(from.addr);
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    ssize_t received = recvmsg(m_fd, &message, 0);
+    truncated = (message.msg_flags & MSG_TRUNC) != 0;
+    return received > 0 ? static_cast<size_t>(received) : 0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <netinet/in.h>
+
+// IPv4 address and port of a peer
+struct NetAddress {
+    sockaddr_in addr{};
+
+    // Parse "host:port" (host may be a name or dotted address)
+    static bool parse(const std::string& text, NetAddress& out);
+
+    bool operator==(const NetAddress& rhs) const {
+        return addr.sin_addr.s_addr == rhs.addr.sin_addr.s_addr && addr.sin_port == rhs.addr.sin_port;
+    }
+
+    std::string toString() const;
+};
+
+// Non-blocking UDP socket
+class UdpSocket {
+    int m_fd = -1;
+
+public:
+    UdpSocket() = default;
+    ~UdpSocket();
+
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // Bind to the given local port (0 picks any free port)
+    bool open(uint16_t port);
+
+    bool send(const NetAddress& to, const uint8_t* data, size_t size);
+
+    // Returns the datagram size, or 0 if nothing is waiting
+    // A datagram longer than capacity is cut short; truncated reports it so it
+    // is not parsed as if it were whole.
+    size_t receive(uint8_t* buffer, size_t capacity, NetAddress& from, bool& truncated);
+
+    bool isOpen() const { return m_fd >= 0; }
+};
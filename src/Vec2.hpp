@@ -1,8 +1,81 @@
-#include <cmath>         // For math functions like sqrt
-#include <stdexcept>     // For std::invalid_argument
-#include <SFML/System.hpp> // For sf::Vector2
+#pragma once
+
+#include <bit>         // For std::bit_cast
+#include <cmath>       // For math functions like sqrt
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define VEC2_SSE 1
+#endif
+#if defined(__AVX2__)
+#define VEC2_AVX2 1
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define VEC2_NEON 1
+#endif
+
+// === Scalar Helpers ===
+namespace vecmath {
+
+// Square root that also works in constant expressions (Newton iteration at compile time)
+template <typename T>
+constexpr T sqrt(T value) noexcept {
+    if (std::is_constant_evaluated()) {
+        if (!(value > T(0))) {
+            return T(0);
+        }
+        T guess = value > T(1) ? value : T(1);
+        for (int i = 0; i < 64; ++i) {
+            T next = (guess + value / guess) / T(2);
+            if (next == guess) {
+                break;
+            }
+            guess = next;
+        }
+        return guess;
+    }
+    return std::sqrt(value);
+}
+
+// Approximate 1 / sqrt(value) for value > 0 (relative error around 1e-6)
+// Uses the hardware estimate refined by Newton-Raphson steps. The estimate
+// differs between Intel, AMD and ARM, so the result is not bit-identical
+// across machines: keep it out of the simulation (lockstep peers must agree).
+constexpr float fastInverseSqrt(float value) noexcept {
+    if (std::is_constant_evaluated()) {
+        return 1.0f / vecmath::sqrt(value);
+    }
+#if VEC2_SSE
+    float estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(value))); // 12-bit estimate
+    return estimate * (1.5f - 0.5f * value * estimate * estimate);
+#elif VEC2_NEON
+    float estimate = vrsqrtes_f32(value); // 8-bit estimate
+    estimate *= vrsqrtss_f32(value * estimate, estimate);
+    return estimate * vrsqrtss_f32(value * estimate, estimate);
+#else
+    float estimate = std::bit_cast<float>(0x5f3759dfu - (std::bit_cast<uint32_t>(value) >> 1));
+    estimate *= 1.5f - 0.5f * value * estimate * estimate;
+    return estimate * (1.5f - 0.5f * value * estimate * estimate);
+#endif
+}
+
+} // namespace vecmath
+
+template <typename T>
+class Vec2;
+
+template <typename T>
+struct isVec2 : std::false_type {};
+template <typename T>
+struct isVec2<Vec2<T>> : std::true_type {};
 
 // Template-based 2D vector class
+// Everything is constexpr and noexcept: division by zero follows IEEE rules
+// instead of throwing, and normalize() returns the zero vector for a zero input.
 template <typename T>
 class Vec2 {
 public:
@@ -10,88 +83,425 @@ public:
     T y;  // Y-coordinate of the vector
 
     // Default constructor (initializes the vector to (0, 0))
-    Vec2() : x(0), y(0) {}
+    constexpr Vec2() noexcept : x(0), y(0) {}
 
     // Constructor with specified x and y values
-    Vec2(T xin, T yin) : x(xin), y(yin) {}
+    constexpr Vec2(T xin, T yin) noexcept : x(xin), y(yin) {}
 
-    // Constructor to convert from an sf::Vector2
-    Vec2(const sf::Vector2<T>& vec) : x(vec.x), y(vec.y) {}
+    // Converts from any 2D vector type with x and y members (e.g. sf::Vector2 or
+    // another Vec2), so this header does not need to include SFML
+    template <typename V>
+        requires (!std::is_same_v<V, Vec2>) && requires(const V& v) { static_cast<T>(v.x); static_cast<T>(v.y); }
+    constexpr Vec2(const V& vec) noexcept : x(static_cast<T>(vec.x)), y(static_cast<T>(vec.y)) {}
 
-    // Conversion operator to convert from Vec2 to sf::Vector2
-    // Allows Vec2 to be used with SFML functions (e.g., setPosition)
-    operator sf::Vector2<T>() {
-        return sf::Vector2<T>(x, y);
+    // Converts to any type constructible from (x, y), e.g. sf::Vector2 for setPosition
+    template <typename V>
+        requires (!isVec2<V>::value) && std::is_constructible_v<V, T, T>
+    constexpr operator V() const noexcept {
+        return V(x, y);
     }
 
     // Addition operator (adds two vectors and returns the result)
-    Vec2 operator+(const Vec2& rhs) const {
+    constexpr Vec2 operator+(const Vec2& rhs) const noexcept {
         return Vec2(x + rhs.x, y + rhs.y);
     }
 
     // Addition assignment operator (adds the given vector to the current one)
-    Vec2& operator+=(const Vec2& rhs) {
+    constexpr Vec2& operator+=(const Vec2& rhs) noexcept {
         x += rhs.x;
         y += rhs.y;
         return *this; // Return the current object by reference
     }
+
     // Subtraction operator (subtracts two vectors and returns the result)
-    Vec2 operator-(const Vec2& rhs) const {
+    constexpr Vec2 operator-(const Vec2& rhs) const noexcept {
         return Vec2(x - rhs.x, y - rhs.y);
     }
 
+    // Subtraction assignment operator
+    constexpr Vec2& operator-=(const Vec2& rhs) noexcept {
+        x -= rhs.x;
+        y -= rhs.y;
+        return *this;
+    }
+
+    // Negation
+    constexpr Vec2 operator-() const noexcept {
+        return Vec2(-x, -y);
+    }
+
     // Scalar multiplication (scales the vector by a scalar value)
-    Vec2 operator*(const T val) const {
+    constexpr Vec2 operator*(const T val) const noexcept {
         return Vec2(x * val, y * val);
     }
 
-    // Scalar division (divides the vector by a scalar value)
-    Vec2 operator/(const T val) const {
-        if (val == 0) {
-            throw std::invalid_argument("Division by zero!"); // Handle division by zero
-        }
+    constexpr Vec2& operator*=(const T val) noexcept {
+        x *= val;
+        y *= val;
+        return *this;
+    }
+
+    // Scalar division (dividing by zero gives infinities/NaN, it does not throw)
+    constexpr Vec2 operator/(const T val) const noexcept {
         return Vec2(x / val, y / val);
     }
 
+    constexpr Vec2& operator/=(const T val) noexcept {
+        x /= val;
+        y /= val;
+        return *this;
+    }
+
     // Dot product (returns the scalar dot product of two vectors)
-    T dot(const Vec2& rhs) const {
+    constexpr T dot(const Vec2& rhs) const noexcept {
         return x * rhs.x + y * rhs.y;
     }
 
+    // 2D cross product (z of the 3D cross product; positive when rhs is counter-clockwise)
+    constexpr T cross(const Vec2& rhs) const noexcept {
+        return x * rhs.y - y * rhs.x;
+    }
+
+    // Squared magnitude (no square root)
+    constexpr T lengthSquared() const noexcept {
+        return x * x + y * y;
+    }
+
     // Magnitude (returns the length of the vector)
-    T magnitude() const {
-        return static_cast<T>(std::sqrt(x * x + y * y));
+    constexpr T magnitude() const noexcept {
+        return static_cast<T>(vecmath::sqrt(lengthSquared()));
     }
 
-    // Normalize the vector (returns a unit vector with the same direction)
-    Vec2 normalize() const {
-        T mag = magnitude();
-        if (mag == 0) {
-            throw std::invalid_argument("Cannot normalize a zero vector!");
+    // Unit vector with the same direction, or (0, 0) for a zero vector
+    [[nodiscard]] constexpr Vec2 normalize() const noexcept {
+        return normalizeOr(Vec2());
+    }
+
+    // Unit vector with the same direction, or fallback for a zero vector
+    [[nodiscard]] constexpr Vec2 normalizeOr(const Vec2& fallback) const noexcept {
+        T lengthSq = lengthSquared();
+        if (!(lengthSq > T(0))) {
+            return fallback;
+        }
+        return *this / static_cast<T>(vecmath::sqrt(lengthSq));
+    }
+
+    // normalize() using the approximate reciprocal square root (float vectors)
+    // Machine-dependent low bits: for drawing and effects, never for game state.
+    [[nodiscard]] constexpr Vec2 fastNormalize() const noexcept {
+        if constexpr (std::is_same_v<T, float>) {
+            float lengthSq = lengthSquared();
+            if (!(lengthSq > 0.0f)) {
+                return Vec2();
+            }
+            return *this * vecmath::fastInverseSqrt(lengthSq);
+        } else {
+            return normalize();
         }
-        return *this / mag; // Divide by magnitude to normalize
     }
 
     // Distance (returns the distance between two vectors)
-    T distance(const Vec2& rhs) const {
+    constexpr T distance(const Vec2& rhs) const noexcept {
         return (*this - rhs).magnitude(); // Distance is the magnitude of the difference vector
     }
 
+    // Squared distance (no square root, for comparisons)
+    constexpr T distanceSquared(const Vec2& rhs) const noexcept {
+        return (*this - rhs).lengthSquared();
+    }
+
     // Equality operator (compares if two vectors are equal)
-    bool operator==(const Vec2& rhs) const {
+    constexpr bool operator==(const Vec2& rhs) const noexcept {
         return x == rhs.x && y == rhs.y;
     }
 
     // Inequality operator (compares if two vectors are not equal)
-    bool operator!=(const Vec2& rhs) const {
+    constexpr bool operator!=(const Vec2& rhs) const noexcept {
         return !(*this == rhs);
     }
 
     // Checks if the vector is the zero vector (both x and y are zero)
-    bool isZero() const {
+    constexpr bool isZero() const noexcept {
         return x == 0 && y == 0;
     }
 };
 
+// Scalar on the left (2.0f * v)
+template <typename T>
+constexpr Vec2<T> operator*(T val, const Vec2<T>& vec) noexcept {
+    return vec * val;
+}
+
 // Typedef for convenience (commonly used with floats)
 using Vec2f = Vec2<float>;
+
+// === Packed Lanes ===
+// Vec2x4 and Vec2x8 hold 4 or 8 float vectors in structure-of-arrays form
+// (all x lanes, then all y lanes) and process them with one instruction per
+// operation: SSE or NEON for Vec2x4, AVX2 for Vec2x8 (two Vec2x4 halves when
+// the build does not enable AVX2). Normalizing keeps zero lanes at zero.
+
+#if VEC2_SSE
+struct Vec2x4 {
+    static constexpr size_t lanes = 4;
+    __m128 x, y;
+
+    static Vec2x4 load(const float* xs, const float* ys) noexcept { return {_mm_loadu_ps(xs), _mm_loadu_ps(ys)}; }
+    void store(float* xs, float* ys) const noexcept {
+        _mm_storeu_ps(xs, x);
+        _mm_storeu_ps(ys, y);
+    }
+
+    Vec2x4 operator+(const Vec2x4& rhs) const noexcept { return {_mm_add_ps(x, rhs.x), _mm_add_ps(y, rhs.y)}; }
+    Vec2x4 operator-(const Vec2x4& rhs) const noexcept { return {_mm_sub_ps(x, rhs.x), _mm_sub_ps(y, rhs.y)}; }
+    Vec2x4 operator*(float s) const noexcept {
+        __m128 scale = _mm_set1_ps(s);
+        return {_mm_mul_ps(x, scale), _mm_mul_ps(y, scale)};
+    }
+
+    // this + velocity * dt
+    Vec2x4 integrate(const Vec2x4& velocity, float dt) const noexcept {
+        __m128 step = _mm_set1_ps(dt);
+        return {_mm_add_ps(x, _mm_mul_ps(velocity.x, step)), _mm_add_ps(y, _mm_mul_ps(velocity.y, step))};
+    }
+
+    __m128 lengthSquared() const noexcept { return _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)); }
+    void length(float* out) const noexcept { _mm_storeu_ps(out, _mm_sqrt_ps(lengthSquared())); }
+
+    Vec2x4 normalize() const noexcept {
+        __m128 lengthSq = lengthSquared();
+        __m128 nonZero = _mm_cmpgt_ps(lengthSq, _mm_setzero_ps());
+        __m128 inverse = _mm_and_ps(nonZero, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSq)));
+        return {_mm_mul_ps(x, inverse), _mm_mul_ps(y, inverse)};
+    }
+
+    Vec2x4 fastNormalize() const noexcept {
+        __m128 lengthSq = lengthSquared();
+        __m128 nonZero = _mm_cmpgt_ps(lengthSq, _mm_setzero_ps());
+        __m128 estimate = _mm_rsqrt_ps(lengthSq);
+        __m128 refine = _mm_sub_ps(_mm_set1_ps(1.5f),
+                                   _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), lengthSq), _mm_mul_ps(estimate, estimate)));
+        __m128 inverse = _mm_and_ps(nonZero, _mm_mul_ps(estimate, refine));
+        return {_mm_mul_ps(x, inverse), _mm_mul_ps(y, inverse)};
+    }
+};
+#elif VEC2_NEON
+struct Vec2x4 {
+    static constexpr size_t lanes = 4;
+    float32x4_t x, y;
+
+    static Vec2x4 load(const float* xs, const float* ys) noexcept { return {vld1q_f32(xs), vld1q_f32(ys)}; }
+    void store(float* xs, float* ys) const noexcept {
+        vst1q_f32(xs, x);
+        vst1q_f32(ys, y);
+    }
+
+    Vec2x4 operator+(const Vec2x4& rhs) const noexcept { return {vaddq_f32(x, rhs.x), vaddq_f32(y, rhs.y)}; }
+    Vec2x4 operator-(const Vec2x4& rhs) const noexcept { return {vsubq_f32(x, rhs.x), vsubq_f32(y, rhs.y)}; }
+    Vec2x4 operator*(float s) const noexcept { return {vmulq_n_f32(x, s), vmulq_n_f32(y, s)}; }
+
+    // this + velocity * dt
+    Vec2x4 integrate(const Vec2x4& velocity, float dt) const noexcept {
+        return {vfmaq_n_f32(x, velocity.x, dt), vfmaq_n_f32(y, velocity.y, dt)};
+    }
+
+    float32x4_t lengthSquared() const noexcept { return vfmaq_f32(vmulq_f32(x, x), y, y); }
+    void length(float* out) const noexcept { vst1q_f32(out, vsqrtq_f32(lengthSquared())); }
+
+    Vec2x4 normalize() const noexcept {
+        float32x4_t lengthSq = lengthSquared();
+        uint32x4_t nonZero = vcgtq_f32(lengthSq, vdupq_n_f32(0.0f));
+        float32x4_t inverse = vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(lengthSq));
+        inverse = vreinterpretq_f32_u32(vandq_u32(nonZero, vreinterpretq_u32_f32(inverse)));
+        return {vmulq_f32(x, inverse), vmulq_f32(y, inverse)};
+    }
+
+    Vec2x4 fastNormalize() const noexcept {
+        float32x4_t lengthSq = lengthSquared();
+        uint32x4_t nonZero = vcgtq_f32(lengthSq, vdupq_n_f32(0.0f));
+        float32x4_t estimate = vrsqrteq_f32(lengthSq);
+        estimate = vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(lengthSq, estimate), estimate));
+        estimate = vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(lengthSq, estimate), estimate));
+        float32x4_t inverse = vreinterpretq_f32_u32(vandq_u32(nonZero, vreinterpretq_u32_f32(estimate)));
+        return {vmulq_f32(x, inverse), vmulq_f32(y, inverse)};
+    }
+};
+#else
+struct Vec2x4 {
+    static constexpr size_t lanes = 4;
+    float x[4], y[4];
+
+    static Vec2x4 load(const float* xs, const float* ys) noexcept {
+        Vec2x4 v;
+        for (size_t i = 0; i < 4; ++i) {
+            v.x[i] = xs[i];
+            v.y[i] = ys[i];
+        }
+        return v;
+    }
+    void store(float* xs, float* ys) const noexcept {
+        for (size_t i = 0; i < 4; ++i) {
+            xs[i] = x[i];
+            ys[i] = y[i];
+        }
+    }
+
+    template <typename Fn>
+    Vec2x4 map(Fn&& fn) const noexcept {
+        Vec2x4 v;
+        for (size_t i = 0; i < 4; ++i) {
+            Vec2f r = fn(Vec2f(x[i], y[i]), i);
+            v.x[i] = r.x;
+            v.y[i] = r.y;
+        }
+        return v;
+    }
+
+    Vec2x4 operator+(const Vec2x4& rhs) const noexcept {
+        return map([&](Vec2f v, size_t i) { return v + Vec2f(rhs.x[i], rhs.y[i]); });
+    }
+    Vec2x4 operator-(const Vec2x4& rhs) const noexcept {
+        return map([&](Vec2f v, size_t i) { return v - Vec2f(rhs.x[i], rhs.y[i]); });
+    }
+    Vec2x4 operator*(float s) const noexcept {
+        return map([&](Vec2f v, size_t) { return v * s; });
+    }
+
+    // this + velocity * dt
+    Vec2x4 integrate(const Vec2x4& velocity, float dt) const noexcept {
+        return map([&](Vec2f v, size_t i) { return v + Vec2f(velocity.x[i], velocity.y[i]) * dt; });
+    }
+
+    void length(float* out) const noexcept {
+        for (size_t i = 0; i < 4; ++i) {
+            out[i] = Vec2f(x[i], y[i]).magnitude();
+        }
+    }
+
+    Vec2x4 normalize() const noexcept {
+        return map([](Vec2f v, size_t) { return v.normalize(); });
+    }
+    Vec2x4 fastNormalize() const noexcept {
+        return map([](Vec2f v, size_t) { return v.fastNormalize(); });
+    }
+};
+#endif
+
+#if VEC2_AVX2
+struct Vec2x8 {
+    static constexpr size_t lanes = 8;
+    __m256 x, y;
+
+    static Vec2x8 load(const float* xs, const float* ys) noexcept { return {_mm256_loadu_ps(xs), _mm256_loadu_ps(ys)}; }
+    void store(float* xs, float* ys) const noexcept {
+        _mm256_storeu_ps(xs, x);
+        _mm256_storeu_ps(ys, y);
+    }
+
+    Vec2x8 operator+(const Vec2x8& rhs) const noexcept { return {_mm256_add_ps(x, rhs.x), _mm256_add_ps(y, rhs.y)}; }
+    Vec2x8 operator-(const Vec2x8& rhs) const noexcept { return {_mm256_sub_ps(x, rhs.x), _mm256_sub_ps(y, rhs.y)}; }
+    Vec2x8 operator*(float s) const noexcept {
+        __m256 scale = _mm256_set1_ps(s);
+        return {_mm256_mul_ps(x, scale), _mm256_mul_ps(y, scale)};
+    }
+
+    // this + velocity * dt
+    Vec2x8 integrate(const Vec2x8& velocity, float dt) const noexcept {
+        __m256 step = _mm256_set1_ps(dt);
+#if defined(__FMA__)
+        return {_mm256_fmadd_ps(velocity.x, step, x), _mm256_fmadd_ps(velocity.y, step, y)};
+#else
+        return {_mm256_add_ps(x, _mm256_mul_ps(velocity.x, step)), _mm256_add_ps(y, _mm256_mul_ps(velocity.y, step))};
+#endif
+    }
+
+    __m256 lengthSquared() const noexcept { return _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)); }
+    void length(float* out) const noexcept { _mm256_storeu_ps(out, _mm256_sqrt_ps(lengthSquared())); }
+
+    Vec2x8 normalize() const noexcept {
+        __m256 lengthSq = lengthSquared();
+        __m256 nonZero = _mm256_cmp_ps(lengthSq, _mm256_setzero_ps(), _CMP_GT_OQ);
+        __m256 inverse = _mm256_and_ps(nonZero, _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(lengthSq)));
+        return {_mm256_mul_ps(x, inverse), _mm256_mul_ps(y, inverse)};
+    }
+
+    Vec2x8 fastNormalize() const noexcept {
+        __m256 lengthSq = lengthSquared();
+        __m256 nonZero = _mm256_cmp_ps(lengthSq, _mm256_setzero_ps(), _CMP_GT_OQ);
+        __m256 estimate = _mm256_rsqrt_ps(lengthSq);
+        __m256 refine = _mm256_sub_ps(_mm256_set1_ps(1.5f),
+                                      _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), lengthSq), _mm256_mul_ps(estimate, estimate)));
+        __m256 inverse = _mm256_and_ps(nonZero, _mm256_mul_ps(estimate, refine));
+        return {_mm256_mul_ps(x, inverse), _mm256_mul_ps(y, inverse)};
+    }
+};
+#else
+struct Vec2x8 {
+    static constexpr size_t lanes = 8;
+    Vec2x4 low, high; // Lanes 0-3 and 4-7
+
+    static Vec2x8 load(const float* xs, const float* ys) noexcept {
+        return {Vec2x4::load(xs, ys), Vec2x4::load(xs + 4, ys + 4)};
+    }
+    void store(float* xs, float* ys) const noexcept {
+        low.store(xs, ys);
+        high.store(xs + 4, ys + 4);
+    }
+
+    Vec2x8 operator+(const Vec2x8& rhs) const noexcept { return {low + rhs.low, high + rhs.high}; }
+    Vec2x8 operator-(const Vec2x8& rhs) const noexcept { return {low - rhs.low, high - rhs.high}; }
+    Vec2x8 operator*(float s) const noexcept { return {low * s, high * s}; }
+
+    // this + velocity * dt
+    Vec2x8 integrate(const Vec2x8& velocity, float dt) const noexcept {
+        return {low.integrate(velocity.low, dt), high.integrate(velocity.high, dt)};
+    }
+
+    void length(float* out) const noexcept {
+        low.length(out);
+        high.length(out + 4);
+    }
+
+    Vec2x8 normalize() const noexcept { return {low.normalize(), high.normalize()}; }
+    Vec2x8 fastNormalize() const noexcept { return {low.fastNormalize(), high.fastNormalize()}; }
+};
+#endif
+
+// === Batch Operations on SoA Arrays ===
+// Whole arrays of n vectors, 8 lanes at a time with a scalar tail.
+
+// position += velocity * dt
+inline void integrateBatch(float* x, float* y, const float* vx, const float* vy, size_t n, float dt) noexcept {
+    size_t i = 0;
+    for (; i + Vec2x8::lanes <= n; i += Vec2x8::lanes) {
+        Vec2x8::load(x + i, y + i).integrate(Vec2x8::load(vx + i, vy + i), dt).store(x + i, y + i);
+    }
+    for (; i < n; ++i) {
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+    }
+}
+
+// out[i] = |(x[i], y[i])|
+inline void lengthBatch(const float* x, const float* y, float* out, size_t n) noexcept {
+    size_t i = 0;
+    for (; i + Vec2x8::lanes <= n; i += Vec2x8::lanes) {
+        Vec2x8::load(x + i, y + i).length(out + i);
+    }
+    for (; i < n; ++i) {
+        out[i] = Vec2f(x[i], y[i]).magnitude();
+    }
+}
+
+// Normalize in place (zero vectors stay zero)
+inline void normalizeBatch(float* x, float* y, size_t n) noexcept {
+    size_t i = 0;
+    for (; i + Vec2x8::lanes <= n; i += Vec2x8::lanes) {
+        Vec2x8::load(x + i, y + i).normalize().store(x + i, y + i);
+    }
+    for (; i < n; ++i) {
+        Vec2f v = Vec2f(x[i], y[i]).normalize();
+        x[i] = v.x;
+        y[i] = v.y;
+    }
+}
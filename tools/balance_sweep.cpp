@@ -0,0 +1,326 @@
+// Balance sweep: plays headless bot games over a grid of balance knobs
+// Usage: balance_sweep --param <name>=<min>:<max>:<points> [--param <name>=<v1>,<v2>,...]
+//                      [--seeds <n>] [--seed <base>] [--duration <seconds>] [--threads <n>]
+//                      --out <results.csv>
+// Every combination of parameter values is played once per seed, on all
+// cores. Seed k is the same for every combination, so differences between
+// rows come from the knobs and not from luck. Rows are appended as games
+// finish; running the same command again skips the games already in the file.
+// The sweep itself (values, seeds, duration) is kept next to the results in
+// <results.csv>.spec, and a file is only resumed by the same sweep.
+
+#include "Game.h"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+struct SweepParam {
+    std::string name;
+    std::vector<double> values;
+};
+
+struct SweepResult {
+    double survivalSeconds = 0.0; // Simulated time until game over (or the duration limit)
+    int score = 0;
+    bool died = false;            // Game over before the duration limit
+    size_t peakEntities = 0;
+    double stepMsMean = 0.0;
+    double stepMsMax = 0.0;
+};
+
+// "name=min:max:points" (evenly spaced, inclusive) or "name=v1,v2,..."
+bool parseParam(const std::string& spec, SweepParam& param) {
+    size_t equals = spec.find('=');
+    if (equals == std::string::npos || equals == 0) {
+        return false;
+    }
+    param.name = spec.substr(0, equals);
+    std::string values = spec.substr(equals + 1);
+
+    if (values.find(':') != std::string::npos) {
+        double min, max;
+        int points;
+        char colon1, colon2;
+        std::istringstream range(values);
+        if (!(range >> min >> colon1 >> max >> colon2 >> points) || colon1 != ':' || colon2 != ':' || points < 1) {
+            return false;
+        }
+        for (int i = 0; i < points; ++i) {
+            param.values.push_back(points == 1 ? min : min + (max - min) * i / (points - 1));
+        }
+        return true;
+    }
+
+    std::istringstream list(values);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        char* end = nullptr;
+        double value = std::strtod(item.c_str(), &end);
+        if (item.empty() || *end != '\0') {
+            return false;
+        }
+        param.values.push_back(value);
+    }
+    return !param.values.empty();
+}
+
+// Seed k of the sweep is substream k of the base seed, as game k of a GameEnv
+// batch is: the game and its bot draw numbers no other seed of the sweep shares
+SweepResult playGame(const std::vector<SweepParam>& params, const std::vector<double>& values,
+                     uint32_t baseSeed, uint32_t k, double duration) {
+    GameOptions options;
+    options.simulationOnly = true;
+    Game game(options);
+    for (size_t p = 0; p < params.size(); ++p) {
+        game.setTunable(params[p].name, values[p]);
+    }
+    game.resetEpisode(baseSeed, k);
+    BotController bot(baseSeed, k);
+
+    const float dt = 1.0f / 60.0f; // Same fixed step as bot runs and training environments
+    SweepResult result;
+    uint64_t steps = 0;
+    double stepMsSum = 0.0;
+    while (!game.episodeOver() && result.survivalSeconds < duration) {
+        auto start = std::chrono::steady_clock::now();
+        game.stepBotEpisode(bot, dt);
+        double stepMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        ++steps;
+        stepMsSum += stepMs;
+        result.stepMsMax = std::max(result.stepMsMax, stepMs);
+        result.peakEntities = std::max(result.peakEntities, game.entityCount());
+        result.survivalSeconds = steps * static_cast<double>(dt);
+    }
+    result.score = game.score();
+    result.died = game.episodeOver();
+    result.stepMsMean = steps > 0 ? stepMsSum / steps : 0.0;
+    return result;
+}
+
+// Jobs already in a results file from an earlier (possibly interrupted) run
+// Only reads the file: complete is set to the length of its whole lines, and
+// the caller cuts a torn last line off once the sweep may resume the file.
+bool loadCompleted(const std::string& path, const std::string& header, std::unordered_set<uint64_t>& completed,
+                   size_t& complete) {
+    std::ifstream input(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    input.close();
+
+    complete = contents.rfind('\n');
+    complete = complete == std::string::npos ? 0 : complete + 1;
+
+    std::istringstream lines(contents.substr(0, complete));
+    std::string line;
+    if (!std::getline(lines, line)) {
+        return true; // Empty: the header is written by the caller
+    }
+    if (line != header) {
+        std::cerr << "Results file " << path << " has different columns; use a new file for a different sweep\n";
+        return false;
+    }
+    while (std::getline(lines, line)) {
+        completed.insert(std::strtoull(line.c_str(), nullptr, 10));
+    }
+    return true;
+}
+
+// Everything that decides which game a job number stands for, one setting per line
+std::string sweepSpec(const std::vector<SweepParam>& params, uint32_t seeds, uint32_t baseSeed, double duration) {
+    std::ostringstream spec;
+    spec << std::setprecision(17);
+    for (const auto& param : params) {
+        spec << "param " << param.name << "=";
+        for (size_t i = 0; i < param.values.size(); ++i) {
+            spec << (i ? "," : "") << param.values[i];
+        }
+        spec << "\n";
+    }
+    spec << "seeds " << seeds << "\nseed " << baseSeed << "\nduration " << duration << "\n";
+    spec << "seeding substreams\n"; // Files from sweeps that hashed seeds play different games
+    return spec.str();
+}
+
+// Writes the spec for a new results file, or checks that an existing file was written by this sweep
+bool matchSpec(const std::string& specPath, const std::string& spec, bool resuming) {
+    if (!resuming) {
+        std::ofstream output(specPath, std::ios::binary | std::ios::trunc);
+        output << spec;
+        if (!output) {
+            std::cerr << "Unable to open file: " << specPath << "\n";
+            return false;
+        }
+        return true;
+    }
+    std::ifstream input(specPath, std::ios::binary);
+    std::string existing((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    if (!input.is_open()) {
+        std::cerr << "Results file has no " << specPath << "; use a new file or restore the spec\n";
+        return false;
+    }
+    if (existing != spec) {
+        std::cerr << "Results file was written by a different sweep (see " << specPath
+                  << "); use a new file or the same values, seeds and duration\n";
+        return false;
+    }
+    return true;
+}
+
+void printUsage() {
+    std::cerr << "Usage: balance_sweep --param <name>=<min>:<max>:<points> [--param <name>=<v1>,<v2>,...]\n"
+                 "                     [--seeds <n>] [--seed <base>] [--duration <seconds>] [--threads <n>]\n"
+                 "                     --out <results.csv>\n"
+                 "Parameters:";
+    for (const auto& name : Game::tunableNames()) {
+        std::cerr << " " << name;
+    }
+    std::cerr << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<SweepParam> params;
+    uint32_t seeds = 4;
+    uint32_t baseSeed = 1;
+    double duration = 600.0;
+    size_t threads = 0;
+    std::string outPath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--param" && i + 1 < argc) {
+            SweepParam param;
+            if (!parseParam(argv[++i], param)) {
+                std::cerr << "Bad parameter range: " << argv[i] << "\n";
+                return 1;
+            }
+            params.push_back(param);
+        } else if (arg == "--seeds" && i + 1 < argc) {
+            seeds = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            baseSeed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--duration" && i + 1 < argc) {
+            duration = std::atof(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+    if (outPath.empty() || duration <= 0.0) {
+        printUsage();
+        return 1;
+    }
+
+    // Every knob is checked up front, so a typo does not cost a whole sweep
+    std::vector<std::string> known = Game::tunableNames();
+    for (const auto& param : params) {
+        if (std::find(known.begin(), known.end(), param.name) == known.end()) {
+            std::cerr << "Unknown parameter: " << param.name << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    // Job j plays combination j / seeds (last parameter varying fastest) with seed j % seeds
+    uint64_t combinations = 1;
+    for (const auto& param : params) {
+        combinations *= param.values.size();
+    }
+    uint64_t jobs = combinations * seeds;
+
+    std::string header = "job,seed";
+    for (const auto& param : params) {
+        header += "," + param.name;
+    }
+    header += ",survival_s,score,died,peak_entities,step_ms_mean,step_ms_max";
+
+    // A refused run leaves the results file as it was
+    std::unordered_set<uint64_t> completed;
+    size_t complete = 0;
+    if (!loadCompleted(outPath, header, completed, complete)) {
+        return 1;
+    }
+    bool resuming = complete > 0;
+    if (!matchSpec(outPath + ".spec", sweepSpec(params, seeds, baseSeed, duration), resuming)) {
+        return 1;
+    }
+
+    // Cut a torn last line off so appended rows start on a line of their own
+    std::error_code error;
+    if (std::filesystem::file_size(outPath, error) > complete && !error) {
+        std::filesystem::resize_file(outPath, complete);
+    }
+    std::ofstream out(outPath, std::ios::app);
+    if (!out) {
+        std::cerr << "Unable to open file: " << outPath << "\n";
+        return 1;
+    }
+    if (!resuming) {
+        out << header << "\n" << std::flush;
+    }
+
+    std::vector<uint64_t> pending;
+    for (uint64_t job = 0; job < jobs; ++job) {
+        if (!completed.count(job)) {
+            pending.push_back(job);
+        }
+    }
+
+    ThreadPool pool(threads);
+    std::cerr << "Sweep: " << jobs << " games (" << combinations << " combinations x " << seeds << " seeds), "
+              << pending.size() << " to play on " << pool.size() << " threads\n";
+
+    std::mutex outMutex;
+    uint64_t finished = 0;
+    auto start = std::chrono::steady_clock::now();
+    pool.parallelFor(pending.size(), [&](size_t i) {
+        uint64_t job = pending[i];
+        uint32_t seed = static_cast<uint32_t>(job % seeds);
+        std::vector<double> values(params.size());
+        uint64_t combination = job / seeds;
+        for (size_t p = params.size(); p-- > 0;) {
+            values[p] = params[p].values[combination % params[p].values.size()];
+            combination /= params[p].values.size();
+        }
+
+        SweepResult result = playGame(params, values, baseSeed, seed, duration);
+
+        std::ostringstream row;
+        row << job << "," << seed;
+        for (double value : values) {
+            row << "," << value;
+        }
+        row << "," << result.survivalSeconds << "," << result.score << "," << (result.died ? 1 : 0) << ","
+            << result.peakEntities << "," << result.stepMsMean << "," << result.stepMsMax << "\n";
+
+        // Each row is flushed whole, so an interrupted sweep loses at most the games in flight
+        std::lock_guard<std::mutex> lock(outMutex);
+        out << row.str() << std::flush;
+        if (++finished % 100 == 0) {
+            std::cerr << finished << "/" << pending.size() << " games\n";
+        }
+    });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "Played " << finished << " games in " << seconds << " s\n";
+    return out.good() ? 0 : 1;
+}
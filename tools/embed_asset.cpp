@@ -0,0 +1,42 @@
+// Build-time tool: turns a binary file into a header with a constexpr byte array
+// Usage: embed_asset <input file> <output header> <symbol name>
+// Produces <symbol>Data (the bytes) and <symbol>Size (the byte count).
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: embed_asset <input> <output.hpp> <symbol>\n";
+        return 1;
+    }
+
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input.is_open()) {
+        std::cerr << "Unable to open file: " << argv[1] << "\n";
+        return 1;
+    }
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    std::ofstream output(argv[2], std::ios::trunc);
+    if (!output.is_open()) {
+        std::cerr << "Unable to open file: " << argv[2] << "\n";
+        return 1;
+    }
+
+    const std::string symbol = argv[3];
+    output << "#pragma once\n\n"
+           << "#include <cstddef>\n\n"
+           << "// Generated from " << argv[1] << " by tools/embed_asset.cpp, do not edit\n"
+           << "inline constexpr unsigned char " << symbol << "Data[] = {";
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        output << (i % 20 == 0 ? "\n    " : "") << static_cast<int>(bytes[i]) << ",";
+    }
+    output << "\n};\n"
+           << "inline constexpr std::size_t " << symbol << "Size = " << bytes.size() << ";\n";
+
+    return output.good() ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+// Measures memory per entity and movement cost for Entity storage and the compact store
+// Usage: entity_footprint [--count <entities>] [--steps <updates>] [--world <pixels>]
+// Fills a square world with moving enemies held both ways, prints the bytes
+// per entity and the total, the time per movement update, and the largest
+// position and velocity error the compact store's fixed point introduces.
+
+#include "CompactEntities.hpp"
+#include "EntityManager.hpp"
+#include "RandomStream.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+double megabytes(size_t bytes) { return bytes / (1024.0 * 1024.0); }
+
+// Milliseconds per call of step, averaged over steps calls
+template <typename Step>
+double timeSteps(int steps, Step&& step) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; ++i) {
+        step();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / std::max(steps, 1);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = 1000000;
+    int steps = 20;
+    float world = 16384.0f;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--count" && i + 1 < argc) {
+            count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--steps" && i + 1 < argc) {
+            steps = std::atoi(argv[++i]);
+        } else if (arg == "--world" && i + 1 < argc) {
+            world = static_cast<float>(std::atof(argv[++i]));
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    const float radius = 35.0f; // Game::enemyRadius
+    const float speed = 130.0f; // Game::enemySpeed
+    const float dt = 1.0f / 120.0f;
+
+    // === Entity storage ===
+    EntityManager entities;
+    RandomStream random(1, RandomStreamId::Spawns);
+    for (size_t i = 0; i < count; ++i) {
+        auto enemy = entities.addEntity("enemy");
+        Vec2<float> position(radius + random.uniform() * (world - 2 * radius), radius + random.uniform() * (world - 2 * radius));
+        float angle = random.uniform() * 6.2831853f;
+        enemy->add<CTransform>(position, Vec2<float>(std::cos(angle), std::sin(angle)) * speed);
+        enemy->add<CShape>(3 + static_cast<int>(random.below(6)), radius,
+                           sf::Color(static_cast<sf::Uint8>(random.below(256)), static_cast<sf::Uint8>(random.below(256)), 255));
+        enemy->add<CCollision>(radius, CollisionLayer::Enemy, true, false);
+        enemy->add<CSpawnTime>(0.0);
+    }
+    entities.update();
+    const EntityVec& enemies = entities.getEntities("enemy");
+
+    // make_shared puts the entity and its reference counts in one block; the
+    // pointer is held in the entity list and in the tag group
+    const size_t entityBytes = sizeof(Entity) + 2 * sizeof(long) + 2 * sizeof(std::shared_ptr<Entity>);
+
+    // === Compact store ===
+    CompactEntityStore compact;
+    compact.reserve(count);
+    compact.setRadius(CompactType::Enemy, radius);
+    for (const auto& enemy : enemies) {
+        compact.add(*enemy);
+    }
+
+    float positionError = 0.0f, velocityError = 0.0f;
+    for (size_t i = 0; i < compact.size(); ++i) {
+        const auto& transform = enemies[i]->get<CTransform>();
+        positionError = std::max(positionError, compact.position(i).distance(transform.position));
+        velocityError = std::max(velocityError, compact.velocity(i).distance(transform.velocity));
+    }
+
+    std::cout << "Entities: " << count << " in a " << world << " px world, " << compact.palette().size() << " palette colors\n\n";
+    std::cout << "Component sizes: CTransform " << sizeof(CTransform) << ", CShape " << sizeof(CShape)
+              << ", CCollision " << sizeof(CCollision) << ", all components " << sizeof(ComponentTuple) << " bytes\n";
+    std::cout << "Entity storage:  " << entityBytes << " bytes per entity (Entity " << sizeof(Entity)
+              << "), " << megabytes(entityBytes * count) << " MB\n";
+    std::cout << "Compact store:   " << CompactEntityStore::bytesPerEntity << " bytes per entity ("
+              << CompactEntityStore::bytesPerEntityWithId << " with id), " << megabytes(compact.memoryBytes()) << " MB\n\n";
+    std::cout << "Largest error after packing: position " << positionError << " px, velocity " << velocityError << " px/s\n\n";
+
+    // === Movement ===
+    // The same update processEnemyMovement does, without the rotation
+    double entityMs = timeSteps(steps, [&] {
+        for (const auto& enemy : enemies) {
+            auto& transform = enemy->get<CTransform>();
+            float r = enemy->get<CShape>().radius;
+            transform.prevPosition = transform.position;
+            transform.position += transform.velocity * dt;
+            if (transform.position.x - r <= 0 || transform.position.x + r >= world) {
+                transform.velocity.x = -transform.velocity.x;
+            }
+            if (transform.position.y - r <= 0 || transform.position.y + r >= world) {
+                transform.velocity.y = -transform.velocity.y;
+            }
+        }
+    });
+    double compactMs = timeSteps(steps, [&] { compact.integrate(dt, world, world); });
+
+    // Apart from rounding, the two only differ where a wall bounce happened one update apart
+    float drift = 0.0f;
+    size_t bouncedApart = 0;
+    for (size_t i = 0; i < compact.size(); ++i) {
+        float distance = compact.position(i).distance(enemies[i]->get<CTransform>().position);
+        if (distance > 0.1f) {
+            ++bouncedApart;
+        } else {
+            drift = std::max(drift, distance);
+        }
+    }
+
+    std::cout << "Movement update: Entity " << entityMs << " ms, compact " << compactMs << " ms\n";
+    std::cout << "Largest divergence after " << steps << " updates: " << drift << " px (" << bouncedApart
+              << " entities bounced an update apart)\n";
+    return 0;
+}
@@ -0,0 +1,152 @@
+// Plays a two-peer lockstep session over loopback UDP and checks both peers stay in sync
+// Usage: lockstep_loopback [--ticks <n>] [--port <port>] [--seed <n>] [--perturb <tick>] [--enemies <n>]
+// A host and a client (simulation-only games in one process) exchange
+// scripted inputs through LockstepSession exactly as windowed peers do. After
+// every tick each records a checksum of its exact simulation state; the tool
+// reports the first tick where they differ and the keyframe corrections the
+// client needed. --perturb changes a balance knob on the client only at that
+// tick, to check that a desync is caught. --enemies fills the world with
+// rings of that many small enemies on both peers, so keyframes span many
+// datagrams. Exits with status 1 on a desync.
+
+#include "Game.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+// Random-access scripted input: the input for a tick only depends on the
+// seed, the slot and the tick, however often or late it is asked for
+PlayerInput scriptedInput(const RandomStream& stream, uint32_t tick, const Vec2<float>& world) {
+    uint64_t first = uint64_t{tick} * 4;
+    uint32_t held = stream.at(uint64_t{tick / 30} * 4); // Movement keys change twice a second
+    uint32_t actions = stream.at(first + 1);
+    PlayerInput input;
+    input.up = held & 1;
+    input.down = held & 2;
+    input.left = held & 4;
+    input.right = held & 8;
+    input.fire = (actions & 7) == 0;
+    input.supermove = (actions >> 3 & 511) == 0;
+    input.aimX = static_cast<int32_t>(RandomStream::toUnit(stream.at(first + 2)) * world.x);
+    input.aimY = static_cast<int32_t>(RandomStream::toUnit(stream.at(first + 3)) * world.y);
+    return input;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t ticks = 3600;
+    uint16_t port = 47810;
+    uint64_t seed = 1;
+    uint32_t perturbTick = LockstepSession::noTick;
+    int enemies = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--ticks" && i + 1 < argc) {
+            ticks = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--port" && i + 1 < argc) {
+            port = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--perturb" && i + 1 < argc) {
+            perturbTick = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--enemies" && i + 1 < argc) {
+            enemies = std::max(0, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    GameOptions options;
+    options.simulationOnly = true;
+    Game host(options), client(options);
+
+    auto hostSession = std::make_unique<LockstepSession>();
+    auto clientSession = std::make_unique<LockstepSession>();
+    if (!hostSession->host(port, 2) || !clientSession->join("127.0.0.1:" + std::to_string(port))) {
+        std::cerr << "Failed to open loopback session on port " << port << "\n";
+        return 1;
+    }
+    host.joinSession(std::move(hostSession));
+    client.joinSession(std::move(clientSession));
+
+    // Crowded world: rings of small enemies instead of the random stream (which
+    // would hold the rings back). The first ring still comes at the usual 30 s,
+    // as the wave script is already waiting, so run at least 3600 ticks
+    if (enemies > 0) {
+        for (Game* peer : {&host, &client}) {
+            peer->setTunable("maxEnemyPerFrame", 0);
+            peer->setTunable("ringWaveSize", enemies);
+            peer->setTunable("ringWaveInterval", 1.0);
+            peer->setTunable("ringWaveRadius", 320.0);
+            peer->setTunable("enemyRadius", 3.0);
+            peer->setTunable("enemySpeed", 20.0);
+        }
+    }
+
+    // Each peer drives its own slot from its own substream of the bot stream
+    RandomStream inputs(seed, RandomStreamId::Bot);
+    RandomStream hostInput = inputs.substream(0), clientInput = inputs.substream(1);
+    Vec2<float> world = host.worldSize();
+    host.setScriptedInput([&](uint32_t tick) { return scriptedInput(hostInput, tick, world); });
+    client.setScriptedInput([&](uint32_t tick) { return scriptedInput(clientInput, tick, world); });
+
+    // Both peers get a 1/60 s frame per round; the session decides when ticks run
+    const float frame = 1.0f / 60.0f;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    bool perturbed = false;
+    while (std::min(host.networkChecksums().size(), client.networkChecksums().size()) < ticks) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            std::cerr << "Timed out after " << host.networkChecksums().size() << " host and "
+                      << client.networkChecksums().size() << " client ticks\n";
+            return 1;
+        }
+        if (!perturbed && client.networkChecksums().size() >= perturbTick) {
+            client.setTunable("enemySpeed", 200.0);
+            perturbed = true;
+        }
+        size_t before = host.networkChecksums().size() + client.networkChecksums().size();
+        host.stepNetwork(frame);
+        client.stepNetwork(frame);
+        if (host.networkChecksums().size() + client.networkChecksums().size() == before) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1)); // Waiting on a packet
+        }
+    }
+
+    const auto& hostSums = host.networkChecksums();
+    const auto& clientSums = client.networkChecksums();
+    uint32_t firstDesync = LockstepSession::noTick;
+    for (uint32_t tick = 0; tick < ticks; ++tick) {
+        if (hostSums[tick] != clientSums[tick]) {
+            firstDesync = tick;
+            break;
+        }
+    }
+
+    const NetStats& stats = client.networkSession()->stats();
+    std::cout << "Ticks: " << ticks << ", host entities " << host.entityCount() << ", client entities "
+              << client.entityCount() << ", score " << host.score() << "\n";
+    std::cout << "Client: " << stats.bytesSent << " bytes sent, " << stats.bytesReceived << " received, "
+              << stats.keyframesReceived << " keyframes, " << stats.corrections << " corrections, "
+              << stats.truncatedPackets << " truncated packets\n";
+    if (firstDesync != LockstepSession::noTick) {
+        std::cout << "DESYNC at tick " << firstDesync << "\n";
+        return 1;
+    }
+    // A keyframe that never arrived whole is only snapped locally, so check the
+    // client received every one it stepped past (taken after ticks 60, 120, ...
+    // up to ticks - 2; the one after tick 0 goes out before the client is confirmed)
+    uint32_t expectedKeyframes = ticks > 1 ? (ticks - 2) / LockstepSession::keyframeInterval : 0;
+    if (stats.keyframesReceived < expectedKeyframes) {
+        std::cout << "Keyframes lost: " << stats.keyframesReceived << " of " << expectedKeyframes << " received\n";
+        return 1;
+    }
+    std::cout << "In sync: every tick's state checksum matches\n";
+    return stats.corrections == 0 ? 0 : 1;
+}